@@ -12,11 +12,34 @@ Camera::Camera(glm::vec3 position, glm::vec3 worldUp)
     , m_zoom{ CameraConstants::defaultZoom }
 {
     UpdateCameraVectors();
+    Rebase();
 }
 
 glm::mat4 Camera::GetViewMatrix()
 {
-    return glm::lookAt(m_cameraPosition, m_cameraPosition + m_cameraDirection, m_cameraUp);
+    return glm::lookAt(glm::vec3{ 0.0f }, m_cameraDirection, m_cameraUp);
+}
+
+glm::vec3 Camera::GetRelativePosition(ChunkCoord chunk, glm::vec3 offset) const
+{
+    const glm::vec3 chunkOffset{
+        static_cast<float>((chunk.x - m_cameraChunk.x) * ChunkConstants::size),
+        static_cast<float>((chunk.y - m_cameraChunk.y) * ChunkConstants::size),
+        static_cast<float>((chunk.z - m_cameraChunk.z) * ChunkConstants::size)
+    };
+
+    return chunkOffset + (offset - m_cameraPosition);
+}
+
+glm::dvec3 Camera::GetWorldPosition() const
+{
+    const glm::dvec3 chunkOrigin{
+        static_cast<double>(Coordinates::chunkToWorld(m_cameraChunk.x)),
+        static_cast<double>(Coordinates::chunkToWorld(m_cameraChunk.y)),
+        static_cast<double>(Coordinates::chunkToWorld(m_cameraChunk.z))
+    };
+
+    return chunkOrigin + glm::dvec3{ m_cameraPosition };
 }
 
 void Camera::ProcessKeyboard(Direction direction, float deltaTime)
@@ -35,6 +58,8 @@ void Camera::ProcessKeyboard(Direction direction, float deltaTime)
         m_cameraPosition -= rightMovement * velocity;
     if (direction == right)
         m_cameraPosition += rightMovement * velocity;
+
+    Rebase();
 }
 
 void Camera::ProcessMouseMovement(float xOffset, float yOffset, GLboolean constrainPitch)
@@ -78,3 +103,14 @@ void Camera::UpdateCameraVectors()
     m_cameraRight = glm::normalize(glm::cross(m_cameraDirection, m_worldUp));
     m_cameraUp = glm::normalize(glm::cross(m_cameraRight, m_cameraDirection));
 }
+
+void Camera::Rebase()
+{
+    constexpr float chunkSize{ static_cast<float>(ChunkConstants::size) };
+    const glm::vec3 chunks{ glm::floor(m_cameraPosition / chunkSize) };
+
+    m_cameraPosition -= chunks * chunkSize;
+    m_cameraChunk.x += static_cast<BlockCoord>(chunks.x);
+    m_cameraChunk.y += static_cast<BlockCoord>(chunks.y);
+    m_cameraChunk.z += static_cast<BlockCoord>(chunks.z);
+}
@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "../World/Coordinates.h"
+
 namespace CameraConstants
 {
     inline constexpr glm::vec3 defaultCameraDirection{ 0.0f, 0.0f, -1.0f };
@@ -28,7 +30,8 @@ public:
         right,
     };
 
-    // Camera attributes
+    // Camera attributes, the position is the chunk holding the camera plus a float offset inside it
+    ChunkCoord m_cameraChunk{};
     glm::vec3 m_cameraPosition{};
     glm::vec3 m_cameraDirection{};
     glm::vec3 m_cameraUp{};
@@ -47,7 +50,7 @@ public:
     // No default constructor, supply with atleast camera position
     Camera() = delete;
 
-    // Constructor using glm::vec3
+    // Constructor using glm::vec3, the position is in world space and gets split into chunk and offset
     Camera(glm::vec3 position, glm::vec3 worldUp = glm::vec3(0.0f, 1.0f, 0.0f));
 
     ~Camera() = default;
@@ -58,8 +61,15 @@ public:
     Camera(Camera&&) = delete;
     Camera& operator=(Camera&&) = delete;
 
+    // Rotation only, everything is rendered relative to the camera so GPU math stays in small floats
     glm::mat4 GetViewMatrix();
 
+    // Where a point given as chunk plus offset sits relative to the camera, chunks are subtracted as integers first
+    glm::vec3 GetRelativePosition(ChunkCoord chunk, glm::vec3 offset = glm::vec3{ 0.0f }) const;
+
+    // Full precision world position for CPU side queries like raycasts
+    glm::dvec3 GetWorldPosition() const;
+
     // Input processing functions
     void ProcessKeyboard(Direction direction, float deltaTime);
     void ProcessMouseMovement(float xOffset, float yOffset, GLboolean constrainPitch = GL_TRUE);
@@ -68,6 +78,9 @@ public:
 private:
 
     void UpdateCameraVectors();
+
+    // Moves whole chunks out of the offset, so it never grows large enough to lose precision
+    void Rebase();
 };
 
 #endif // !CAMERA_H
@@ -0,0 +1,56 @@
+#include "ChunkMesh.h"
+
+ChunkMesh::ChunkMesh(const ChunkMeshData& data)
+    : m_vbo{ data.format == MeshConstants::floatVertices ? VBO{ data.vertices, GL_STATIC_DRAW }
+        : VBO{ data.format == MeshConstants::faceInstances ? data.faceInstances : data.packedVertices, GL_STATIC_DRAW } }
+    , m_vertexCount{ static_cast<GLsizei>(data.getVertexCount()) }
+    , m_instanceCount{ static_cast<GLsizei>(data.format == MeshConstants::faceInstances ? data.faceCount : 0) }
+    , m_format{ data.format }
+{
+    // One record per face, there is no per-vertex buffer since the shader builds corners from gl_VertexID
+    if (m_format == MeshConstants::faceInstances)
+    {
+        constexpr GLsizei stride{ MeshConstants::wordsPerInstance * sizeof(GLuint) };
+        m_vao.LinkAttribI(m_vbo, 0, 1, GL_UNSIGNED_INT, stride, 0);                // Position, face and size
+        m_vao.LinkAttribI(m_vbo, 1, 1, GL_UNSIGNED_INT, stride, sizeof(GLuint));   // Block
+        m_vao.SetAttribDivisor(0, 1);
+        m_vao.SetAttribDivisor(1, 1);
+        return;
+    }
+
+    if (m_format == MeshConstants::packedVertices)
+    {
+        constexpr GLsizei stride{ MeshConstants::wordsPerVertex * sizeof(GLuint) };
+        m_vao.LinkAttribI(m_vbo, 0, 1, GL_UNSIGNED_INT, stride, 0);                // Position and face
+        m_vao.LinkAttribI(m_vbo, 1, 1, GL_UNSIGNED_INT, stride, sizeof(GLuint));   // Block
+        return;
+    }
+
+    constexpr GLsizei stride{ MeshConstants::floatsPerVertex * sizeof(GLfloat) };
+    m_vao.LinkAttrib(m_vbo, 0, 3, GL_FLOAT, stride, 0);                    // Position
+    m_vao.LinkAttrib(m_vbo, 1, 3, GL_FLOAT, stride, 3 * sizeof(GLfloat));  // Normal
+    m_vao.LinkAttrib(m_vbo, 2, 2, GL_FLOAT, stride, 6 * sizeof(GLfloat));  // Texture Coord
+}
+
+void ChunkMesh::Draw()
+{
+    if (m_vertexCount == 0)
+        return;
+
+    m_vao.Bind();
+    if (m_format == MeshConstants::faceInstances)
+        glDrawArraysInstanced(GL_TRIANGLES, 0, MeshConstants::verticesPerFace, m_instanceCount);
+    else
+        glDrawArrays(GL_TRIANGLES, 0, m_vertexCount);
+    m_vao.Unbind();
+}
+
+GLsizei ChunkMesh::GetVertexCount() const
+{
+    return m_vertexCount;
+}
+
+MeshConstants::VertexFormat ChunkMesh::GetFormat() const
+{
+    return m_format;
+}
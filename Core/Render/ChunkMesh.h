@@ -0,0 +1,45 @@
+#ifndef CHUNK_MESH_H
+#define CHUNK_MESH_H
+
+#include <glad/glad.h>
+
+#include "VAO.h"
+#include "VBO.h"
+#include "../World/ChunkMesher.h"
+
+/*
+    GPU side of one meshed chunk, drawn with a model matrix placing the chunk's corner. Float
+    meshes go through lightingVert.glsl, packed ones through chunkVert.glsl and face instances
+    through chunkInstanceVert.glsl.
+*/
+class ChunkMesh
+{
+public:
+    // No default constructor, a mesh always has its vertices
+    ChunkMesh() = delete;
+
+    // Uploads the vertices once, a rebuilt chunk gets a new mesh
+    explicit ChunkMesh(const ChunkMeshData& data);
+
+    ~ChunkMesh() = default;
+
+    // Deleted copy and move operations, the VAO and VBO can't be moved either
+    ChunkMesh(const ChunkMesh&) = delete;
+    ChunkMesh& operator=(const ChunkMesh&) = delete;
+    ChunkMesh(ChunkMesh&&) = delete;
+    ChunkMesh& operator=(ChunkMesh&&) = delete;
+
+    void Draw();
+
+    GLsizei GetVertexCount() const;
+    MeshConstants::VertexFormat GetFormat() const;
+
+private:
+    VAO m_vao{};
+    VBO m_vbo;
+    GLsizei m_vertexCount{};
+    GLsizei m_instanceCount{};
+    MeshConstants::VertexFormat m_format{};
+};
+
+#endif // !CHUNK_MESH_H
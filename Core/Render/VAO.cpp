@@ -22,6 +22,25 @@ void VAO::LinkAttrib(VBO& vbo, GLuint layout, GLint size, GLenum type, GLsizei s
     Unbind();
 }
 
+void VAO::LinkAttribI(VBO& vbo, GLuint layout, GLint size, GLenum type, GLsizei stride, std::size_t offset)
+{
+    Bind();
+    vbo.Bind();
+
+    glVertexAttribIPointer(layout, size, type, stride, reinterpret_cast<const void*>(offset));
+    glEnableVertexAttribArray(layout);
+
+    vbo.Unbind();
+    Unbind();
+}
+
+void VAO::SetAttribDivisor(GLuint layout, GLuint divisor)
+{
+    Bind();
+    glVertexAttribDivisor(layout, divisor);
+    Unbind();
+}
+
 void VAO::Bind()
 {
     glBindVertexArray(m_id);
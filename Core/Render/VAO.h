@@ -25,6 +25,12 @@ public:
     // Sets the vertex attrib pointer
     void LinkAttrib(VBO& vbo, GLuint layout, GLint size, GLenum type, GLsizei stride, std::size_t offset);
 
+    // Integer attributes reach the shader unconverted, declare them as int or uint there
+    void LinkAttribI(VBO& vbo, GLuint layout, GLint size, GLenum type, GLsizei stride, std::size_t offset);
+
+    // Advances the attribute once per divisor instances instead of once per vertex, 0 restores per vertex
+    void SetAttribDivisor(GLuint layout, GLuint divisor);
+
     // Bind and unbind the VAO
     void Bind();
     void Unbind();
@@ -9,6 +9,15 @@ VBO::VBO(std::span<const GLfloat> data, GLenum usage)
     Unbind();
 }
 
+VBO::VBO(std::span<const GLuint> data, GLenum usage)
+{
+    glGenBuffers(1, &m_id);
+
+    Bind();
+    glBufferData(GL_ARRAY_BUFFER, data.size_bytes(), data.data(), usage);
+    Unbind();
+}
+
 VBO::~VBO()
 {
     glDeleteBuffers(1, &m_id);
@@ -17,6 +17,9 @@ public:
     // Constructor for VBO, remember to pass correct GLenum type!
     VBO(std::span<const GLfloat> data, GLenum usage = GL_STATIC_DRAW);
 
+    // Same for integer vertex data, link it with VAO::LinkAttribI
+    VBO(std::span<const GLuint> data, GLenum usage = GL_STATIC_DRAW);
+
     // Destructor -> deletes VBO
     ~VBO();
 
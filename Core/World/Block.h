@@ -0,0 +1,21 @@
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include <cstdint>
+
+// Every voxel in the world is stored as a block id
+using BlockID = std::uint16_t;
+
+// Properties live in BlockRegistry.h, a new id also needs a definition there
+namespace Blocks
+{
+    inline constexpr BlockID air{ 0 };
+    inline constexpr BlockID stone{ 1 };
+    inline constexpr BlockID dirt{ 2 };
+    inline constexpr BlockID grass{ 3 };
+    inline constexpr BlockID glass{ 4 };
+    inline constexpr BlockID lamp{ 5 };
+    inline constexpr BlockID water{ 6 };
+}
+
+#endif // !BLOCK_H
@@ -0,0 +1,136 @@
+#include "BlockEntityTable.h"
+
+#include <bit>
+#include <utility>
+
+// === Helper Functions === //
+namespace
+{
+    using BlockEntityConstants::emptyKey;
+    using BlockEntityConstants::Key;
+}
+
+// === BlockEntityTable Class === //
+BlockEntity* BlockEntityTable::find(int index)
+{
+    return const_cast<BlockEntity*>(std::as_const(*this).find(index));
+}
+
+const BlockEntity* BlockEntityTable::find(int index) const
+{
+    if (m_size == 0)
+        return nullptr;
+
+    const std::size_t slot{ probe(static_cast<Key>(index)) };
+    return m_keys[slot] != emptyKey ? &m_entities[slot] : nullptr;
+}
+
+BlockEntity& BlockEntityTable::insert(int index, BlockEntity entity)
+{
+    // Grown before probing, the slot found has to stay valid
+    if ((m_size + 1) * 2 > m_keys.size())
+        rehash(std::max(BlockEntityConstants::minCapacity, m_keys.size() * 2));
+
+    const Key key{ static_cast<Key>(index) };
+    const std::size_t slot{ probe(key) };
+    if (m_keys[slot] == emptyKey)
+    {
+        m_keys[slot] = key;
+        ++m_size;
+    }
+
+    m_entities[slot] = std::move(entity);
+    return m_entities[slot];
+}
+
+bool BlockEntityTable::erase(int index)
+{
+    if (m_size == 0)
+        return false;
+
+    std::size_t hole{ probe(static_cast<Key>(index)) };
+    if (m_keys[hole] == emptyKey)
+        return false;
+
+    // Backward shift: pull later entries of the probe run into the hole whenever their home allows it
+    const std::size_t mask{ m_keys.size() - 1 };
+    for (std::size_t next{ (hole + 1) & mask }; m_keys[next] != emptyKey; next = (next + 1) & mask)
+    {
+        const std::size_t home{ homeSlot(m_keys[next]) };
+        if (((next - home) & mask) < ((next - hole) & mask))
+            continue;
+
+        m_keys[hole] = m_keys[next];
+        m_entities[hole] = std::move(m_entities[next]);
+        hole = next;
+    }
+
+    m_keys[hole] = emptyKey;
+    m_entities[hole] = BlockEntity{};
+    --m_size;
+    return true;
+}
+
+void BlockEntityTable::clear()
+{
+    std::vector<Key>{}.swap(m_keys);
+    std::vector<BlockEntity>{}.swap(m_entities);
+    m_size = 0;
+    m_capacityLog2 = 0;
+}
+
+std::size_t BlockEntityTable::size() const
+{
+    return m_size;
+}
+
+bool BlockEntityTable::empty() const
+{
+    return m_size == 0;
+}
+
+std::size_t BlockEntityTable::getMemoryUsage() const
+{
+    std::size_t bytes{ m_keys.capacity() * sizeof(Key) + m_entities.capacity() * sizeof(BlockEntity) };
+    for (std::size_t slot{ 0 }; slot < m_keys.size(); ++slot)
+    {
+        if (m_keys[slot] != emptyKey)
+            bytes += m_entities[slot].data.capacity();
+    }
+
+    return bytes;
+}
+
+std::size_t BlockEntityTable::homeSlot(Key key) const
+{
+    return static_cast<std::size_t>((static_cast<std::uint32_t>(key) * 0x9E3779B1u) >> (32 - m_capacityLog2));
+}
+
+std::size_t BlockEntityTable::probe(Key key) const
+{
+    const std::size_t mask{ m_keys.size() - 1 };
+    std::size_t slot{ homeSlot(key) };
+    while (m_keys[slot] != key && m_keys[slot] != emptyKey)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+void BlockEntityTable::rehash(std::size_t capacity)
+{
+    std::vector<Key> keys(capacity, emptyKey);
+    std::vector<BlockEntity> entities(capacity);
+    keys.swap(m_keys);
+    entities.swap(m_entities);
+
+    m_capacityLog2 = std::countr_zero(capacity);
+    for (std::size_t slot{ 0 }; slot < keys.size(); ++slot)
+    {
+        if (keys[slot] == emptyKey)
+            continue;
+
+        const std::size_t target{ probe(keys[slot]) };
+        m_keys[target] = keys[slot];
+        m_entities[target] = std::move(entities[slot]);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef BLOCK_ENTITY_TABLE_H
+#define BLOCK_ENTITY_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Block.h"
+#include "Coordinates.h"
+
+namespace BlockEntityConstants
+{
+    // Keys are Coordinates::localToIndex values, the all-ones key marks an empty slot
+    using Key = std::uint16_t;
+    inline constexpr Key emptyKey{ std::numeric_limits<Key>::max() };
+    static_assert(ChunkConstants::volume <= emptyKey, "Every voxel index needs a key below the empty marker");
+
+    // Capacity is a power of two kept at least twice the entry count, so probes stay short
+    inline constexpr std::size_t minCapacity{ 16 };
+}
+
+// Extra state of one block, what the bytes mean is up to the block that owns them
+struct BlockEntity
+{
+    // The block the state belongs to, the chunk drops the entity once that block is replaced
+    BlockID block{ Blocks::air };
+    std::vector<std::uint8_t> data{};
+};
+
+/*
+    Sparse per-chunk map from voxel index to block entity.
+
+    Open addressing with linear probing over a flat key array, so lookups touch one small
+    contiguous array and inserting never allocates a node. Erasing shifts the following
+    entries back instead of leaving tombstones. Iteration for saving goes in index order.
+*/
+class BlockEntityTable
+{
+public:
+    BlockEntityTable() = default;
+
+    // Null when the voxel has no entity
+    BlockEntity* find(int index);
+    const BlockEntity* find(int index) const;
+
+    // Inserts or replaces the entity of the voxel
+    BlockEntity& insert(int index, BlockEntity entity);
+    bool erase(int index);
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t getMemoryUsage() const;
+
+    // fn(int index, const BlockEntity& entity) in ascending index order
+    template <typename Fn>
+    void forEachSorted(Fn&& fn) const
+    {
+        std::vector<std::size_t> slots{};
+        slots.reserve(m_size);
+        for (std::size_t slot{ 0 }; slot < m_keys.size(); ++slot)
+        {
+            if (m_keys[slot] != BlockEntityConstants::emptyKey)
+                slots.push_back(slot);
+        }
+
+        std::sort(slots.begin(), slots.end(), [this](std::size_t a, std::size_t b) { return m_keys[a] < m_keys[b]; });
+        for (std::size_t slot : slots)
+            fn(static_cast<int>(m_keys[slot]), m_entities[slot]);
+    }
+
+    // Erases every entity pred(int index, const BlockEntity& entity) accepts, returns how many
+    template <typename Pred>
+    std::size_t eraseIf(Pred&& pred)
+    {
+        std::vector<int> doomed{};
+        for (std::size_t slot{ 0 }; slot < m_keys.size(); ++slot)
+        {
+            if (m_keys[slot] != BlockEntityConstants::emptyKey && pred(static_cast<int>(m_keys[slot]), m_entities[slot]))
+                doomed.push_back(m_keys[slot]);
+        }
+
+        // Erasing shifts entries around, so the keys are collected first
+        for (int index : doomed)
+            erase(index);
+
+        return doomed.size();
+    }
+
+private:
+    // Home slot of a key, Fibonacci hashing spreads neighbouring voxels across the table
+    std::size_t homeSlot(BlockEntityConstants::Key key) const;
+
+    // Slot holding the key, or the empty slot where it would go
+    std::size_t probe(BlockEntityConstants::Key key) const;
+
+    void rehash(std::size_t capacity);
+
+    std::vector<BlockEntityConstants::Key> m_keys{};
+    std::vector<BlockEntity> m_entities{};
+    std::size_t m_size{ 0 };
+    int m_capacityLog2{ 0 };
+};
+
+#endif // !BLOCK_ENTITY_TABLE_H
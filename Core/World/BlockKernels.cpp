@@ -0,0 +1,120 @@
+#include "BlockKernels.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#define BLOCK_KERNELS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define BLOCK_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// === Helper Functions === //
+namespace
+{
+#if defined(BLOCK_KERNELS_AVX2)
+    using Vector = __m256i;
+    constexpr std::size_t lanes{ 16 };
+
+    Vector load(const BlockID* blocks) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks)); }
+    void store(BlockID* blocks, Vector value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(blocks), value); }
+    Vector broadcast(BlockID block) { return _mm256_set1_epi16(static_cast<short>(block)); }
+    Vector equal(Vector a, Vector b) { return _mm256_cmpeq_epi16(a, b); }
+    Vector select(Vector mask, Vector yes, Vector no) { return _mm256_blendv_epi8(no, yes, mask); }
+
+    // Two bits per matching lane
+    unsigned byteMask(Vector mask) { return static_cast<unsigned>(_mm256_movemask_epi8(mask)); }
+#elif defined(BLOCK_KERNELS_SSE2)
+    using Vector = __m128i;
+    constexpr std::size_t lanes{ 8 };
+
+    Vector load(const BlockID* blocks) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks)); }
+    void store(BlockID* blocks, Vector value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(blocks), value); }
+    Vector broadcast(BlockID block) { return _mm_set1_epi16(static_cast<short>(block)); }
+    Vector equal(Vector a, Vector b) { return _mm_cmpeq_epi16(a, b); }
+
+    // SSE2 has no blend, the compare mask is all ones or all zeros per lane
+    Vector select(Vector mask, Vector yes, Vector no) { return _mm_or_si128(_mm_and_si128(mask, yes), _mm_andnot_si128(mask, no)); }
+
+    unsigned byteMask(Vector mask) { return static_cast<unsigned>(_mm_movemask_epi8(mask)); }
+#endif
+}
+
+// === BlockKernels Functions === //
+std::size_t BlockKernels::countEqual(const BlockID* blocks, std::size_t count, BlockID block)
+{
+    std::size_t matches{ 0 };
+    std::size_t i{ 0 };
+
+#if defined(BLOCK_KERNELS_AVX2) || defined(BLOCK_KERNELS_SSE2)
+    const Vector needle{ broadcast(block) };
+    std::size_t maskBits{ 0 };
+    for (; i + lanes <= count; i += lanes)
+        maskBits += std::popcount(byteMask(equal(load(blocks + i), needle)));
+    matches = maskBits / 2;
+#endif
+
+    for (; i < count; ++i)
+        matches += blocks[i] == block;
+
+    return matches;
+}
+
+std::size_t BlockKernels::findEqual(const BlockID* blocks, std::size_t count, BlockID block)
+{
+    std::size_t i{ 0 };
+
+#if defined(BLOCK_KERNELS_AVX2) || defined(BLOCK_KERNELS_SSE2)
+    const Vector needle{ broadcast(block) };
+    for (; i + lanes <= count; i += lanes)
+    {
+        const unsigned mask{ byteMask(equal(load(blocks + i), needle)) };
+        if (mask != 0)
+            return i + std::countr_zero(mask) / 2;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        if (blocks[i] == block)
+            return i;
+    }
+
+    return count;
+}
+
+std::size_t BlockKernels::replaceEqual(BlockID* blocks, std::size_t count, BlockID from, BlockID to)
+{
+    std::size_t replaced{ 0 };
+    std::size_t i{ 0 };
+
+#if defined(BLOCK_KERNELS_AVX2) || defined(BLOCK_KERNELS_SSE2)
+    const Vector needle{ broadcast(from) };
+    const Vector replacement{ broadcast(to) };
+    std::size_t maskBits{ 0 };
+    for (; i + lanes <= count; i += lanes)
+    {
+        const Vector value{ load(blocks + i) };
+        const Vector mask{ equal(value, needle) };
+        const unsigned bits{ byteMask(mask) };
+        if (bits == 0)
+            continue;
+
+        store(blocks + i, select(mask, replacement, value));
+        maskBits += std::popcount(bits);
+    }
+    replaced = maskBits / 2;
+#endif
+
+    for (; i < count; ++i)
+    {
+        if (blocks[i] == from)
+        {
+            blocks[i] = to;
+            ++replaced;
+        }
+    }
+
+    return replaced;
+}
@@ -0,0 +1,26 @@
+#ifndef BLOCK_KERNELS_H
+#define BLOCK_KERNELS_H
+
+#include <cstddef>
+
+#include "Block.h"
+
+/*
+    Vectorised loops over flat runs of block ids.
+
+    AVX2 handles 16 ids per step and SSE2 8, picked at compile time from the target flags
+    (/arch:AVX2 or -mavx2 for the wide path). 16-bit compares and blends need nothing past
+    SSE2, which every x86-64 CPU has; other targets use the scalar loops.
+*/
+namespace BlockKernels
+{
+    std::size_t countEqual(const BlockID* blocks, std::size_t count, BlockID block);
+
+    // Index of the first match, count when there is none
+    std::size_t findEqual(const BlockID* blocks, std::size_t count, BlockID block);
+
+    // Overwrites every from with to and returns how many were replaced
+    std::size_t replaceEqual(BlockID* blocks, std::size_t count, BlockID from, BlockID to);
+}
+
+#endif // !BLOCK_KERNELS_H
@@ -0,0 +1,177 @@
+#ifndef BLOCK_REGISTRY_H
+#define BLOCK_REGISTRY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+#include "Block.h"
+
+namespace BlockProperties
+{
+    // Hides faces behind it and blocks light
+    inline constexpr std::uint8_t opaque{ 1 << 0 };
+
+    // Collides with entities
+    inline constexpr std::uint8_t solid{ 1 << 1 };
+
+    // Gives off light, the definition carries the level
+    inline constexpr std::uint8_t emissive{ 1 << 2 };
+
+    // Drawn in the blended pass, faces behind it stay visible
+    inline constexpr std::uint8_t transparent{ 1 << 3 };
+
+    // Flows and can be swum through, never solid
+    inline constexpr std::uint8_t fluid{ 1 << 4 };
+}
+
+struct BlockDefinition
+{
+    BlockID id{};
+    std::string_view name{};
+    std::uint8_t properties{};
+
+    // Light level 0 to 15, non-zero exactly when the block is emissive
+    std::uint8_t emission{};
+};
+
+namespace BlockDefinitions
+{
+    // One entry per block id in id order, the checks in BlockRegistry reject anything else
+    inline constexpr BlockDefinition table[]{
+        { Blocks::air, "air", 0, 0 },
+        { Blocks::stone, "stone", BlockProperties::opaque | BlockProperties::solid, 0 },
+        { Blocks::dirt, "dirt", BlockProperties::opaque | BlockProperties::solid, 0 },
+        { Blocks::grass, "grass", BlockProperties::opaque | BlockProperties::solid, 0 },
+        { Blocks::glass, "glass", BlockProperties::solid | BlockProperties::transparent, 0 },
+        { Blocks::lamp, "lamp", BlockProperties::opaque | BlockProperties::solid | BlockProperties::emissive, 15 },
+        { Blocks::water, "water", BlockProperties::transparent | BlockProperties::fluid, 0 },
+    };
+}
+
+/*
+    Block properties compiled into structure-of-arrays tables indexed by block id.
+
+    Every predicate is one bit test on a table built at compile time, so the mesher and physics
+    can ask per voxel without a map lookup or virtual call. Ids outside the registry read as air,
+    so an id written through setBlock or left by a newer build never indexes past the tables.
+*/
+namespace BlockRegistry
+{
+    inline constexpr std::size_t count{ std::size(BlockDefinitions::table) };
+
+    // One bit per block id, 64 ids per word
+    using PropertyBits = std::array<std::uint64_t, (count + 63) / 64>;
+
+    namespace Detail
+    {
+        constexpr bool idsMatchPositions()
+        {
+            for (std::size_t i{ 0 }; i < count; ++i)
+            {
+                if (BlockDefinitions::table[i].id != i)
+                    return false;
+            }
+            return true;
+        }
+
+        constexpr bool namesAreUnique()
+        {
+            for (std::size_t i{ 0 }; i < count; ++i)
+            {
+                if (BlockDefinitions::table[i].name.empty())
+                    return false;
+
+                for (std::size_t j{ i + 1 }; j < count; ++j)
+                {
+                    if (BlockDefinitions::table[i].name == BlockDefinitions::table[j].name)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool propertiesAreConsistent()
+        {
+            for (const BlockDefinition& block : BlockDefinitions::table)
+            {
+                const bool opaque{ (block.properties & BlockProperties::opaque) != 0 };
+                const bool transparent{ (block.properties & BlockProperties::transparent) != 0 };
+                const bool emissive{ (block.properties & BlockProperties::emissive) != 0 };
+                const bool solid{ (block.properties & BlockProperties::solid) != 0 };
+                const bool fluid{ (block.properties & BlockProperties::fluid) != 0 };
+
+                if (opaque && transparent)
+                    return false;
+                if (fluid && solid)
+                    return false;
+                if (emissive != (block.emission != 0) || block.emission > 15)
+                    return false;
+            }
+            return true;
+        }
+
+        constexpr PropertyBits buildBits(std::uint8_t property)
+        {
+            PropertyBits bits{};
+            for (const BlockDefinition& block : BlockDefinitions::table)
+            {
+                if ((block.properties & property) != 0)
+                    bits[block.id >> 6] |= std::uint64_t{ 1 } << (block.id & 63);
+            }
+            return bits;
+        }
+
+        constexpr std::array<std::uint8_t, count> buildEmission()
+        {
+            std::array<std::uint8_t, count> levels{};
+            for (const BlockDefinition& block : BlockDefinitions::table)
+                levels[block.id] = block.emission;
+            return levels;
+        }
+
+        constexpr std::array<std::string_view, count> buildNames()
+        {
+            std::array<std::string_view, count> names{};
+            for (const BlockDefinition& block : BlockDefinitions::table)
+                names[block.id] = block.name;
+            return names;
+        }
+
+        constexpr bool test(const PropertyBits& bits, BlockID id)
+        {
+            return id < count && ((bits[id >> 6] >> (id & 63)) & 1);
+        }
+    }
+
+    static_assert(Detail::idsMatchPositions(), "Block definitions must list every id once, in id order starting at air");
+    static_assert(Detail::namesAreUnique(), "Block definitions need a unique, non-empty name");
+    static_assert(Detail::propertiesAreConsistent(), "A block can't be both opaque and transparent or both fluid and solid, and emission must be 1-15 exactly when emissive");
+    static_assert(BlockDefinitions::table[Blocks::air].properties == 0, "Air must have no properties, empty chunks rely on it");
+
+    inline constexpr PropertyBits opaqueBits{ Detail::buildBits(BlockProperties::opaque) };
+    inline constexpr PropertyBits solidBits{ Detail::buildBits(BlockProperties::solid) };
+    inline constexpr PropertyBits emissiveBits{ Detail::buildBits(BlockProperties::emissive) };
+    inline constexpr PropertyBits transparentBits{ Detail::buildBits(BlockProperties::transparent) };
+    inline constexpr PropertyBits fluidBits{ Detail::buildBits(BlockProperties::fluid) };
+
+    inline constexpr std::array<std::uint8_t, count> emission{ Detail::buildEmission() };
+    inline constexpr std::array<std::string_view, count> names{ Detail::buildNames() };
+
+    inline constexpr bool isKnown(BlockID id) { return id < count; }
+
+    inline constexpr bool isOpaque(BlockID id) { return Detail::test(opaqueBits, id); }
+    inline constexpr bool isSolid(BlockID id) { return Detail::test(solidBits, id); }
+    inline constexpr bool isEmissive(BlockID id) { return Detail::test(emissiveBits, id); }
+    inline constexpr bool isTransparent(BlockID id) { return Detail::test(transparentBits, id); }
+    inline constexpr bool isFluid(BlockID id) { return Detail::test(fluidBits, id); }
+
+    inline constexpr std::uint8_t getEmission(BlockID id) { return isKnown(id) ? emission[id] : 0; }
+    inline constexpr std::string_view getName(BlockID id) { return names[isKnown(id) ? id : Blocks::air]; }
+
+    static_assert(!isOpaque(count) && !isSolid(BlockID{ 0xFFFF }) && getEmission(BlockID{ 0xFFFF }) == 0, "Unknown ids must read as air");
+}
+
+#endif // !BLOCK_REGISTRY_H
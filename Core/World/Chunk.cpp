@@ -0,0 +1,438 @@
+#include "Chunk.h"
+
+#include "ChunkCompression.h"
+#include "EpochManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+Chunk::Chunk(ChunkCoord coord)
+    : m_coord{ coord }
+    , m_storage{ makePooled<PaletteStorage>() }
+{
+}
+
+Chunk::~Chunk()
+{
+    unpublish();
+}
+
+BlockID Chunk::getBlock(int x, int y, int z) const
+{
+    return readStorage().get(ChunkLayout::index(x, y, z));
+}
+
+void Chunk::setBlock(int x, int y, int z, BlockID block)
+{
+    const int index{ ChunkLayout::index(x, y, z) };
+
+    // Checked first so writing an unchanged block never splits shared storage
+    if (readStorage().get(index) == block)
+        return;
+
+    writeStorage().set(index, block);
+    if (m_occupancy && m_occupancy->test(x, y, z) != (block != Blocks::air))
+    {
+        if (m_occupancy.use_count() > 1)
+            m_occupancy = std::make_shared<ChunkOccupancy>(*m_occupancy);
+
+        m_occupancy->set(x, y, z, block != Blocks::air);
+    }
+    if (!m_blockEntities.empty())
+        m_blockEntities.erase(Coordinates::localToIndex(x, y, z));
+
+    m_dirty = true;
+    ++m_version;
+}
+
+void Chunk::fill(BlockID block)
+{
+    std::vector<std::uint16_t>{}.swap(m_compressed);
+    m_isCompressed = false;
+    m_occupancy.reset();
+
+    // Shared storage is replaced rather than cloned, none of it survives a fill
+    if (!m_storage || m_storage.use_count() > 1)
+        m_storage = makePooled<PaletteStorage>(block);
+    else
+        m_storage->fill(block);
+
+    dropStaleBlockEntities();
+    m_dirty = true;
+    ++m_version;
+}
+
+void Chunk::decodeBlocks(std::span<BlockID> out) const
+{
+    const PaletteStorage& storage{ readStorage() };
+
+    if constexpr (std::is_same_v<ChunkLayout, VoxelLayout::Linear>)
+    {
+        storage.decode(out);
+    }
+    else
+    {
+        if (storage.isUniform())
+        {
+            storage.decode(out);
+            return;
+        }
+
+        // Decode in storage order, then gather into linear order row by row
+        PooledBuffer<BlockID> stored{ ChunkConstants::volume };
+        storage.decode(stored);
+
+        int linear{ 0 };
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                    out[linear++] = stored[ChunkLayout::index(x, y, z)];
+    }
+}
+
+void Chunk::encodeBlocks(std::span<const BlockID> blocks)
+{
+    std::vector<std::uint16_t>{}.swap(m_compressed);
+    m_isCompressed = false;
+    m_occupancy.reset();
+
+    if (!m_storage || m_storage.use_count() > 1)
+        m_storage = makePooled<PaletteStorage>();
+
+    if constexpr (std::is_same_v<ChunkLayout, VoxelLayout::Linear>)
+    {
+        m_storage->encode(blocks);
+    }
+    else
+    {
+        PooledBuffer<BlockID> stored{ ChunkConstants::volume };
+
+        int linear{ 0 };
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                    stored[ChunkLayout::index(x, y, z)] = blocks[linear++];
+
+        m_storage->encode(stored);
+    }
+
+    dropStaleBlockEntities();
+    m_dirty = true;
+    ++m_version;
+}
+
+void Chunk::assignStorage(PaletteStorage storage)
+{
+    std::vector<std::uint16_t>{}.swap(m_compressed);
+    m_isCompressed = false;
+    m_occupancy.reset();
+
+    // A fresh block rather than an overwrite, the old one may be shared or published
+    m_storage = makePooled<PaletteStorage>(std::move(storage));
+
+    dropStaleBlockEntities();
+    m_dirty = true;
+    ++m_version;
+}
+
+bool Chunk::isUniform() const
+{
+    return readStorage().isUniform();
+}
+
+BlockID Chunk::getUniformBlock() const
+{
+    return readStorage().getUniformBlock();
+}
+
+bool Chunk::isEmpty() const
+{
+    const PaletteStorage& storage{ readStorage() };
+    return storage.isUniform() && storage.getUniformBlock() == Blocks::air;
+}
+
+const ChunkOccupancy& Chunk::getOccupancy() const
+{
+    const PaletteStorage& storage{ readStorage() };
+    if (storage.isUniform())
+        return ChunkOccupancy::uniform(storage.getUniformBlock() != Blocks::air);
+
+    if (!m_occupancy)
+    {
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+        decodeBlocks(blocks);
+
+        m_occupancy = std::make_shared<ChunkOccupancy>();
+        m_occupancy->build(blocks);
+    }
+
+    return *m_occupancy;
+}
+
+const BlockEntity* Chunk::getBlockEntity(int x, int y, int z) const
+{
+    return m_blockEntities.find(Coordinates::localToIndex(x, y, z));
+}
+
+bool Chunk::setBlockEntity(int x, int y, int z, std::vector<std::uint8_t> data)
+{
+    const BlockID block{ getBlock(x, y, z) };
+    if (block == Blocks::air)
+        return false;
+
+    m_blockEntities.insert(Coordinates::localToIndex(x, y, z), BlockEntity{ block, std::move(data) });
+
+    // Nothing to remesh, but the chunk has to be saved again
+    ++m_version;
+    return true;
+}
+
+bool Chunk::removeBlockEntity(int x, int y, int z)
+{
+    if (!m_blockEntities.erase(Coordinates::localToIndex(x, y, z)))
+        return false;
+
+    ++m_version;
+    return true;
+}
+
+const BlockEntityTable& Chunk::getBlockEntities() const
+{
+    return m_blockEntities;
+}
+
+const PaletteStorage& Chunk::getStorage() const
+{
+    return readStorage();
+}
+
+std::size_t Chunk::getMemoryUsage() const
+{
+    const std::size_t storage{ m_storage ? m_storage->getMemoryUsage() : 0 };
+    const std::size_t occupancy{ m_occupancy ? sizeof(ChunkOccupancy) : 0 };
+    return sizeof(Chunk) + storage + occupancy + m_blockEntities.getMemoryUsage() + getCompressedSize();
+}
+
+void Chunk::compress()
+{
+    // Uniform chunks already own no voxel memory, shared storage is cheaper left shared
+    if (m_isCompressed || m_storage->isUniform() || isStorageShared())
+        return;
+
+    PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+    m_storage->decode(blocks);
+
+    std::vector<std::uint16_t> runs{ ChunkCompression::compress(blocks) };
+    if (runs.size() * sizeof(std::uint16_t) >= m_storage->getMemoryUsage())
+        return;
+
+    m_compressed = std::move(runs);
+    m_isCompressed = true;
+
+    // Releases the packed buffers, the runs are the only copy from here on
+    unpublish();
+    m_storage.reset();
+    m_occupancy.reset();
+}
+
+bool Chunk::isCompressed() const
+{
+    return m_isCompressed;
+}
+
+std::size_t Chunk::getCompressedSize() const
+{
+    return m_compressed.capacity() * sizeof(std::uint16_t);
+}
+
+std::uint64_t Chunk::getContentHash() const
+{
+    const PaletteStorage& storage{ readStorage() };
+    if (storage.isUniform())
+        return storage.getUniformBlock();
+
+    PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+    storage.decode(blocks);
+
+    // Hashes decoded ids, so equal chunks match whatever their palette order or index width
+    std::uint64_t hash{ 0x9E3779B97F4A7C15ull };
+    for (std::size_t i{ 0 }; i < blocks.size(); i += 4)
+    {
+        std::uint64_t word{};
+        std::memcpy(&word, &blocks[i], sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+
+    return hash;
+}
+
+bool Chunk::hasSameContent(const Chunk& other) const
+{
+    if (sharesStorageWith(other))
+        return true;
+
+    const PaletteStorage& storage{ readStorage() };
+    const PaletteStorage& otherStorage{ other.readStorage() };
+    if (storage.isUniform() || otherStorage.isUniform())
+    {
+        return storage.isUniform() && otherStorage.isUniform()
+            && storage.getUniformBlock() == otherStorage.getUniformBlock();
+    }
+
+    PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+    PooledBuffer<BlockID> otherBlocks{ ChunkConstants::volume };
+    storage.decode(blocks);
+    otherStorage.decode(otherBlocks);
+
+    return std::equal(blocks.data(), blocks.data() + blocks.size(), otherBlocks.data());
+}
+
+bool Chunk::isStorageShared() const
+{
+    if (!m_storage)
+        return false;
+
+    // Our own published version holds a reference too, it doesn't count as sharing
+    const bool published{ m_publishedOwner && m_publishedOwner->storage == m_storage };
+    return m_storage.use_count() > (published ? 2 : 1);
+}
+
+bool Chunk::sharesStorageWith(const Chunk& other) const
+{
+    return m_storage && m_storage == other.m_storage;
+}
+
+void Chunk::shareStorageWith(const Chunk& other)
+{
+    other.readStorage();
+
+    std::vector<std::uint16_t>{}.swap(m_compressed);
+    m_isCompressed = false;
+    m_storage = other.m_storage;
+}
+
+void Chunk::touch(double time) const
+{
+    m_lastAccess = time;
+}
+
+double Chunk::getLastAccess() const
+{
+    return m_lastAccess;
+}
+
+void Chunk::publish()
+{
+    const ChunkVersion* published{ m_published.load() };
+    if (m_isCompressed)
+    {
+        if (published)
+            unpublish();
+        return;
+    }
+
+    // Any edit since the last publish cloned or replaced the storage, so an unchanged pointer means nothing to do
+    if (published && published->storage == m_storage && published->version == m_version)
+        return;
+
+    // Uniform chunks publish the static bitmaps through an owner-less pointer
+    const ChunkOccupancy& occupancy{ getOccupancy() };
+    std::shared_ptr<const ChunkOccupancy> publishedOccupancy{ m_occupancy };
+    if (&occupancy != m_occupancy.get())
+        publishedOccupancy = std::shared_ptr<const ChunkOccupancy>{ std::shared_ptr<const ChunkOccupancy>{}, &occupancy };
+
+    std::shared_ptr<const ChunkVersion> next{ std::make_shared<const ChunkVersion>(m_storage, m_version, std::move(publishedOccupancy)) };
+    m_published.store(next.get());
+
+    EpochManager::instance().retire(std::move(m_publishedOwner));
+    m_publishedOwner = std::move(next);
+}
+
+const ChunkVersion* Chunk::getPublished() const
+{
+    return m_published.load();
+}
+
+std::uint64_t Chunk::getVersion() const
+{
+    return m_version;
+}
+
+void Chunk::unpublish()
+{
+    m_published.store(nullptr);
+    EpochManager::instance().retire(std::move(m_publishedOwner));
+    m_publishedOwner.reset();
+}
+
+void Chunk::dropStaleBlockEntities()
+{
+    if (m_blockEntities.empty())
+        return;
+
+    const PaletteStorage& storage{ readStorage() };
+    m_blockEntities.eraseIf([&](int index, const BlockEntity& entity) {
+        const LocalPos local{ VoxelLayout::Linear::position(index) };
+        return storage.get(ChunkLayout::index(local.x, local.y, local.z)) != entity.block;
+    });
+}
+
+void Chunk::decompress() const
+{
+    PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+    ChunkCompression::decompress(m_compressed, blocks);
+
+    m_storage = makePooled<PaletteStorage>();
+    m_storage->encode(blocks);
+    std::vector<std::uint16_t>{}.swap(m_compressed);
+    m_isCompressed = false;
+}
+
+const PaletteStorage& Chunk::readStorage() const
+{
+    if (m_isCompressed)
+        decompress();
+
+    return *m_storage;
+}
+
+PaletteStorage& Chunk::writeStorage()
+{
+    if (m_isCompressed)
+        decompress();
+
+    // Copy-on-write, other chunks and the published version keep the original
+    if (m_storage.use_count() > 1)
+        m_storage = makePooled<PaletteStorage>(*m_storage);
+
+    return *m_storage;
+}
+
+ChunkCoord Chunk::getCoord() const
+{
+    return m_coord;
+}
+
+bool Chunk::isDirty() const
+{
+    return m_dirty;
+}
+
+void Chunk::clearDirty()
+{
+    m_dirty = false;
+}
+
+bool Chunk::isModifiedSinceSave() const
+{
+    return m_version != m_savedVersion;
+}
+
+void Chunk::markSaved()
+{
+    m_savedVersion = m_version;
+}
@@ -0,0 +1,166 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Block.h"
+#include "BlockEntityTable.h"
+#include "ChunkOccupancy.h"
+#include "Coordinates.h"
+#include "PaletteStorage.h"
+#include "VoxelLayout.h"
+
+// Immutable published state of a chunk, workers read it while pinned by an EpochGuard
+struct ChunkVersion
+{
+    std::shared_ptr<const PaletteStorage> storage{};
+    std::uint64_t version{};
+
+    // Bitmaps matching storage, so worker snapshots can hand them to the mesher
+    std::shared_ptr<const ChunkOccupancy> occupancy{};
+};
+
+class Chunk
+{
+public:
+    // No default constructor, a chunk always knows where it lives
+    Chunk() = delete;
+
+    // Constructor, every block starts as air
+    explicit Chunk(ChunkCoord coord);
+
+    // Retires the published version, a pinned worker may still be reading it
+    ~Chunk();
+
+    // Deleted copy and move operations, chunks are owned by the world through pointers
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+    Chunk(Chunk&&) = delete;
+    Chunk& operator=(Chunk&&) = delete;
+
+    // Block access using local coordinates, no bounds checking
+    BlockID getBlock(int x, int y, int z) const;
+    void setBlock(int x, int y, int z, BlockID block);
+
+    // Fills the whole chunk with a single block
+    void fill(BlockID block);
+
+    // Unpacks every block into a flat array indexed by Coordinates::localToIndex, meant for the mesher
+    void decodeBlocks(std::span<BlockID> out) const;
+
+    // Replaces the whole chunk from a flat array indexed by Coordinates::localToIndex
+    void encodeBlocks(std::span<const BlockID> blocks);
+
+    // Replaces the whole chunk with storage built elsewhere, the deserializer hands over packed indices as is
+    void assignStorage(PaletteStorage storage);
+
+    // Uniform chunks hold one block id and no voxel array
+    bool isUniform() const;
+    BlockID getUniformBlock() const;
+
+    // All air, the mesher and lighting can skip the chunk entirely
+    bool isEmpty() const;
+
+    // Built on first use and then kept up to date by setBlock, uniform chunks share a static instance
+    const ChunkOccupancy& getOccupancy() const;
+
+    /*
+        Block entities keep extra state for the few blocks that need it in a side table keyed by
+        voxel, so the voxel array stays dense and narrow. Replacing a block drops its entity, and
+        an entity can't be attached to air.
+    */
+    const BlockEntity* getBlockEntity(int x, int y, int z) const;
+    bool setBlockEntity(int x, int y, int z, std::vector<std::uint8_t> data);
+    bool removeBlockEntity(int x, int y, int z);
+
+    // Keyed by Coordinates::localToIndex, iterate with forEachSorted when saving
+    const BlockEntityTable& getBlockEntities() const;
+
+    // Storage is indexed by ChunkLayout, see ChunkIterators.h for layout-agnostic traversal
+    const PaletteStorage& getStorage() const;
+    std::size_t getMemoryUsage() const;
+
+    /*
+        Idle chunks can be compressed in place. Every accessor above decompresses transparently,
+        so callers never need to check; compress() is a no-op when it wouldn't save memory.
+    */
+    void compress();
+    bool isCompressed() const;
+    std::size_t getCompressedSize() const;
+
+    /*
+        Identical chunks can share one storage block. Sharing is copy-on-write: the first edit
+        to a shared chunk clones the storage, so sharing is invisible to every other accessor.
+    */
+    std::uint64_t getContentHash() const;
+    bool hasSameContent(const Chunk& other) const;
+    bool isStorageShared() const;
+    bool sharesStorageWith(const Chunk& other) const;
+
+    // Drops this chunk's storage in favour of other's, the caller checks hasSameContent first
+    void shareStorageWith(const Chunk& other);
+
+    // Time of the last access through the world, used by the idle policies
+    void touch(double time) const;
+    double getLastAccess() const;
+
+    /*
+        Versioning for workers. The main thread edits freely and publish() makes the current
+        state visible, after which the first edit clones the storage instead of touching what
+        workers read. Replaced versions are retired to the EpochManager and freed once no
+        worker still pins them. Compressed chunks publish nothing.
+    */
+    void publish();
+
+    // Worker-side read, null when nothing is published; only valid while an EpochGuard is held
+    const ChunkVersion* getPublished() const;
+
+    // Bumped on every edit, meshes and lighting compare it to tell whether they are stale
+    std::uint64_t getVersion() const;
+
+    ChunkCoord getCoord() const;
+
+    // Dirty is raised on every edit so the renderer knows when to rebuild
+    bool isDirty() const;
+    void clearDirty();
+
+    // Edited since the chunk was last written to or read from disk, separate from the renderer's flag
+    bool isModifiedSinceSave() const;
+    void markSaved();
+
+private:
+    ChunkCoord m_coord{};
+    bool m_dirty{ true };
+    std::uint64_t m_version{ 0 };
+    std::uint64_t m_savedVersion{ 0 };
+
+    // Mutable so const readers can decompress on first access, null while compressed
+    mutable std::shared_ptr<PaletteStorage> m_storage{};
+    mutable std::vector<std::uint16_t> m_compressed{};
+    mutable bool m_isCompressed{ false };
+    mutable double m_lastAccess{};
+    // Shared with the published version until the next edit clones it, like the storage
+    mutable std::shared_ptr<ChunkOccupancy> m_occupancy{};
+    BlockEntityTable m_blockEntities{};
+
+    // The owner keeps the published version alive, workers only ever load the raw pointer
+    std::shared_ptr<const ChunkVersion> m_publishedOwner{};
+    std::atomic<const ChunkVersion*> m_published{ nullptr };
+
+    void decompress() const;
+    void unpublish();
+
+    // Drops entities whose voxel no longer holds the block they were made for
+    void dropStaleBlockEntities();
+
+    // Read access decompresses, write access also splits shared storage
+    const PaletteStorage& readStorage() const;
+    PaletteStorage& writeStorage();
+};
+
+#endif // !CHUNK_H
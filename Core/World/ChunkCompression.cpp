@@ -0,0 +1,39 @@
+#include "ChunkCompression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+std::vector<std::uint16_t> ChunkCompression::compress(std::span<const BlockID> blocks)
+{
+    std::vector<std::uint16_t> runs{};
+
+    std::size_t start{ 0 };
+    while (start < blocks.size())
+    {
+        const BlockID block{ blocks[start] };
+        std::size_t end{ start + 1 };
+        while (end < blocks.size() && end - start <= UINT16_MAX && blocks[end] == block)
+            ++end;
+
+        runs.push_back(block);
+        runs.push_back(static_cast<std::uint16_t>(end - start - 1));
+        start = end;
+    }
+
+    runs.shrink_to_fit();
+    return runs;
+}
+
+void ChunkCompression::decompress(std::span<const std::uint16_t> runs, std::span<BlockID> out)
+{
+    auto it{ out.begin() };
+    for (std::size_t i{ 0 }; i + 1 < runs.size(); i += 2)
+    {
+        const std::size_t length{ static_cast<std::size_t>(runs[i + 1]) + 1 };
+        assert(static_cast<std::size_t>(out.end() - it) >= length);
+        it = std::fill_n(it, length, runs[i]);
+    }
+
+    assert(it == out.end());
+}
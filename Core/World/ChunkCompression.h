@@ -0,0 +1,25 @@
+#ifndef CHUNK_COMPRESSION_H
+#define CHUNK_COMPRESSION_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Block.h"
+
+/*
+    Run-length codec for idle chunks.
+
+    Runs are taken in storage order, which with the linear layout follows whole x rows and y layers,
+    so layered terrain and large air pockets collapse into a handful of runs.
+    Each run is two 16-bit words: the block id and the run length minus one.
+*/
+namespace ChunkCompression
+{
+    std::vector<std::uint16_t> compress(std::span<const BlockID> blocks);
+
+    // out must hold exactly as many blocks as were compressed
+    void decompress(std::span<const std::uint16_t> runs, std::span<BlockID> out);
+}
+
+#endif // !CHUNK_COMPRESSION_H
@@ -0,0 +1,312 @@
+#include "ChunkFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "BlockRegistry.h"
+#include "ChunkPool.h"
+#include "PaletteStorage.h"
+#include "VoxelLayout.h"
+
+// === Helper Functions === //
+namespace
+{
+    using namespace ChunkFormatConstants;
+
+    constexpr std::size_t alignUp(std::size_t bytes)
+    {
+        return (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool isKnownLayout(std::uint8_t layout)
+    {
+        return layout == VoxelLayout::Linear::id || layout == VoxelLayout::Morton::id;
+    }
+
+    bool isKnownWidth(int bits)
+    {
+        return bits == PaletteConstants::uniformBits || bits == 1 || bits == 2 || bits == 4 || bits == 8 || bits == PaletteConstants::directBits;
+    }
+
+    int storageIndex(std::uint8_t layout, int x, int y, int z)
+    {
+        return layout == VoxelLayout::Morton::id ? VoxelLayout::Morton::index(x, y, z) : VoxelLayout::Linear::index(x, y, z);
+    }
+
+    // Ids saved by a build registering more blocks, live palette entries or every direct id; free palette slots never read back
+    bool holdsUnknownBlocks(const ChunkView& view)
+    {
+        if (view.isUniform())
+            return !BlockRegistry::isKnown(view.getUniformBlock());
+
+        // Four ids a word at once: adding 0x8000 - count to each low 15 bits carries into bit 15 exactly when the id is
+        // count or more, and ids with bit 15 already set are unknown anyway. No lane can carry into the next
+        if (view.getBitsPerEntry() == PaletteConstants::directBits)
+        {
+            static_assert(BlockRegistry::count <= 0x8000, "Ids past the registry have to fit the low 15 bits of a lane");
+            constexpr std::uint64_t lanes{ 0x0001000100010001ull };
+            constexpr std::uint64_t offset{ (0x8000 - BlockRegistry::count) * lanes };
+
+            std::uint64_t unknown{ 0 };
+            for (std::uint64_t word : view.getIndexWords())
+                unknown |= ((word & (0x7FFF * lanes)) + offset) | word;
+
+            return (unknown & (0x8000 * lanes)) != 0;
+        }
+
+        const std::span<const BlockID> palette{ view.getPalette() };
+        const std::span<const std::uint16_t> counts{ view.getCounts() };
+        for (std::size_t entry{ 0 }; entry < palette.size(); ++entry)
+        {
+            if (counts[entry] != 0 && !BlockRegistry::isKnown(palette[entry]))
+                return true;
+        }
+
+        return false;
+    }
+
+    // Typed view of a section, the caller has checked its bounds and alignment
+    template <typename T>
+    std::span<const T> sectionAs(std::span<const std::byte> bytes, const ChunkFormatSection& section)
+    {
+        return { reinterpret_cast<const T*>(bytes.data() + section.offset), section.size / sizeof(T) };
+    }
+}
+
+// === ChunkView Class === //
+std::optional<ChunkView> ChunkView::open(std::span<const std::byte> bytes)
+{
+    if (bytes.size() < sizeof(ChunkFormatHeader) || reinterpret_cast<std::uintptr_t>(bytes.data()) % alignment != 0)
+        return std::nullopt;
+
+    ChunkView view{};
+    std::memcpy(&view.m_header, bytes.data(), sizeof(ChunkFormatHeader));
+
+    const ChunkFormatHeader& header{ view.m_header };
+    if (header.magic != magic || header.version != formatVersion || header.totalSize > bytes.size()
+        || !isKnownLayout(header.layout) || !isKnownWidth(header.bitsPerEntry))
+        return std::nullopt;
+
+    for (const ChunkFormatSection& section : header.sections)
+    {
+        const bool inside{ section.offset >= sizeof(ChunkFormatHeader) && section.size <= header.totalSize - section.offset };
+        if (section.offset % alignment != 0 || section.offset > header.totalSize || !inside)
+            return std::nullopt;
+    }
+
+    bytes = bytes.first(header.totalSize);
+    const auto& sections{ header.sections };
+    const std::size_t expectedWords{ static_cast<std::size_t>(ChunkConstants::volume) * header.bitsPerEntry / 64 };
+    if (sections[palette].size % sizeof(BlockID) != 0 || sections[palette].size != sections[counts].size
+        || sections[indices].size != expectedWords * sizeof(std::uint64_t) || sections[entities].size % sizeof(ChunkFormatEntity) != 0)
+        return std::nullopt;
+
+    view.m_palette = sectionAs<BlockID>(bytes, sections[palette]);
+    view.m_counts = sectionAs<std::uint16_t>(bytes, sections[counts]);
+    view.m_words = sectionAs<std::uint64_t>(bytes, sections[indices]);
+    view.m_light = sectionAs<std::uint8_t>(bytes, sections[light]);
+    view.m_entities = sectionAs<ChunkFormatEntity>(bytes, sections[entities]);
+    view.m_entityData = sectionAs<std::uint8_t>(bytes, sections[entityData]);
+
+    // Checked once here so lookups can binary search and slice without bounds checks
+    int previous{ -1 };
+    for (const ChunkFormatEntity& entity : view.m_entities)
+    {
+        const bool dataInside{ entity.dataOffset <= view.m_entityData.size() && entity.dataSize <= view.m_entityData.size() - entity.dataOffset };
+        if (entity.index <= previous || entity.index >= ChunkConstants::volume || !dataInside)
+            return std::nullopt;
+
+        previous = entity.index;
+    }
+
+    return view;
+}
+
+ChunkCoord ChunkView::getCoord() const
+{
+    return ChunkCoord{ m_header.x, m_header.y, m_header.z };
+}
+
+std::size_t ChunkView::getSize() const
+{
+    return m_header.totalSize;
+}
+
+std::uint8_t ChunkView::getLayout() const
+{
+    return m_header.layout;
+}
+
+int ChunkView::getBitsPerEntry() const
+{
+    return m_header.bitsPerEntry;
+}
+
+bool ChunkView::isUniform() const
+{
+    return m_header.bitsPerEntry == PaletteConstants::uniformBits;
+}
+
+BlockID ChunkView::getUniformBlock() const
+{
+    return m_header.uniformBlock;
+}
+
+BlockID ChunkView::getBlock(int x, int y, int z) const
+{
+    if (isUniform())
+        return m_header.uniformBlock;
+
+    const int bits{ m_header.bitsPerEntry };
+    const auto bitOffset{ static_cast<std::size_t>(storageIndex(m_header.layout, x, y, z)) * bits };
+    const std::uint64_t mask{ (std::uint64_t{ 1 } << bits) - 1 };
+    const auto value{ static_cast<std::size_t>((m_words[bitOffset >> 6] >> (bitOffset & 63)) & mask) };
+
+    if (bits == PaletteConstants::directBits)
+        return static_cast<BlockID>(value);
+
+    // Indices aren't validated on open, one past the palette reads as air
+    return value < m_palette.size() ? m_palette[value] : Blocks::air;
+}
+
+std::span<const BlockID> ChunkView::getPalette() const
+{
+    return m_palette;
+}
+
+std::span<const std::uint16_t> ChunkView::getCounts() const
+{
+    return m_counts;
+}
+
+std::span<const std::uint64_t> ChunkView::getIndexWords() const
+{
+    return m_words;
+}
+
+std::span<const std::uint8_t> ChunkView::getLight() const
+{
+    return m_light;
+}
+
+std::size_t ChunkView::getBlockEntityCount() const
+{
+    return m_entities.size();
+}
+
+std::optional<BlockEntityView> ChunkView::findBlockEntity(int index) const
+{
+    const auto it{ std::lower_bound(m_entities.begin(), m_entities.end(), index, [](const ChunkFormatEntity& entity, int key) {
+        return entity.index < key;
+    }) };
+
+    if (it == m_entities.end() || it->index != index)
+        return std::nullopt;
+
+    return BlockEntityView{ it->block, m_entityData.subspan(it->dataOffset, it->dataSize) };
+}
+
+// === ChunkFormat Functions === //
+std::vector<std::byte> ChunkFormat::serialize(const Chunk& chunk)
+{
+    const PaletteStorage& storage{ chunk.getStorage() };
+    const std::span<const BlockID> paletteEntries{ storage.getPalette() };
+    const std::span<const std::uint16_t> paletteCounts{ storage.getCounts() };
+    const std::span<const std::uint64_t> words{ storage.getWords() };
+
+    // Entity records and their data are gathered first, the data section's size depends on them
+    std::vector<ChunkFormatEntity> records{};
+    std::size_t dataSize{ 0 };
+    chunk.getBlockEntities().forEachSorted([&](int index, const BlockEntity& entity) {
+        records.push_back({ static_cast<std::uint16_t>(index), entity.block, static_cast<std::uint32_t>(dataSize), static_cast<std::uint32_t>(entity.data.size()) });
+        dataSize += entity.data.size();
+    });
+
+    ChunkFormatHeader header{};
+    const ChunkCoord coord{ chunk.getCoord() };
+    header.layout = ChunkLayout::id;
+    header.bitsPerEntry = static_cast<std::uint8_t>(storage.getBitsPerEntry());
+    header.x = coord.x;
+    header.y = coord.y;
+    header.z = coord.z;
+    header.uniformBlock = storage.getUniformBlock();
+
+    const std::size_t sizes[sectionCount]{
+        paletteEntries.size_bytes(), paletteCounts.size_bytes(), words.size_bytes(), 0, records.size() * sizeof(ChunkFormatEntity), dataSize
+    };
+
+    std::size_t offset{ sizeof(ChunkFormatHeader) };
+    for (int section{ 0 }; section < sectionCount; ++section)
+    {
+        header.sections[section] = { static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(sizes[section]) };
+        offset = alignUp(offset + sizes[section]);
+    }
+    header.totalSize = static_cast<std::uint32_t>(offset);
+
+    // Zero-filled so padding between sections is deterministic
+    std::vector<std::byte> bytes(offset);
+    auto write{ [&](int section, const void* source) {
+        if (sizes[section] != 0)
+            std::memcpy(bytes.data() + header.sections[section].offset, source, sizes[section]);
+    } };
+
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    write(palette, paletteEntries.data());
+    write(counts, paletteCounts.data());
+    write(indices, words.data());
+    write(entities, records.data());
+
+    std::byte* data{ bytes.data() + header.sections[entityData].offset };
+    chunk.getBlockEntities().forEachSorted([&](int, const BlockEntity& entity) {
+        if (!entity.data.empty())
+            std::memcpy(data, entity.data.data(), entity.data.size());
+        data += entity.data.size();
+    });
+
+    return bytes;
+}
+
+bool ChunkFormat::load(const ChunkView& view, Chunk& chunk)
+{
+    if (view.getLayout() == ChunkLayout::id && !holdsUnknownBlocks(view))
+    {
+        // Same layout and only registered ids, the packed words and stored counts are taken as they are
+        PaletteStorage storage{};
+        if (!storage.assign(view.getBitsPerEntry(), view.getUniformBlock(), view.getPalette(), view.getCounts(), view.getIndexWords(), PaletteConstants::trustCounts))
+        {
+            std::cout << "Inconsistent palette in serialized chunk\n";
+            return false;
+        }
+
+        chunk.assignStorage(std::move(storage));
+    }
+    else
+    {
+        // Another layout or ids this build doesn't register, which read as air like everywhere else; only a decode can do either
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+        {
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+            {
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                {
+                    const BlockID block{ view.getBlock(x, y, z) };
+                    blocks[Coordinates::localToIndex(x, y, z)] = BlockRegistry::isKnown(block) ? block : Blocks::air;
+                }
+            }
+        }
+
+        chunk.encodeBlocks(blocks);
+    }
+
+    // An entity whose block doesn't match its voxel is skipped, like one left behind by an edit
+    view.forEachBlockEntity([&](int index, const BlockEntityView& entity) {
+        const LocalPos local{ VoxelLayout::Linear::position(index) };
+        if (chunk.getBlock(local.x, local.y, local.z) == entity.block)
+            chunk.setBlockEntity(local.x, local.y, local.z, { entity.data.begin(), entity.data.end() });
+    });
+
+    return true;
+}
@@ -0,0 +1,161 @@
+#ifndef CHUNK_FORMAT_H
+#define CHUNK_FORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Block.h"
+#include "Chunk.h"
+#include "Coordinates.h"
+
+namespace ChunkFormatConstants
+{
+    inline constexpr std::uint32_t magic{ 0x46435856 }; // "VXCF" read little-endian
+    inline constexpr std::uint16_t formatVersion{ 1 };
+
+    // Every section starts on this boundary, so arrays can be read straight out of the buffer
+    inline constexpr std::size_t alignment{ 8 };
+
+    enum Section
+    {
+        palette,
+        counts,
+        indices,
+        light,
+        entities,
+        entityData,
+        sectionCount,
+    };
+}
+
+// Byte range of one section, offsets count from the start of the header
+struct ChunkFormatSection
+{
+    std::uint32_t offset{};
+    std::uint32_t size{};
+};
+
+struct ChunkFormatHeader
+{
+    std::uint32_t magic{ ChunkFormatConstants::magic };
+    std::uint16_t version{ ChunkFormatConstants::formatVersion };
+
+    // VoxelLayout id of the packed indices and their width, 0 for uniform chunks
+    std::uint8_t layout{};
+    std::uint8_t bitsPerEntry{};
+
+    std::int64_t x{};
+    std::int64_t y{};
+    std::int64_t z{};
+
+    BlockID uniformBlock{};
+    std::uint16_t reserved{};
+    std::uint32_t totalSize{};
+
+    std::array<ChunkFormatSection, ChunkFormatConstants::sectionCount> sections{};
+};
+
+// One block entity, sorted by index so a view can binary search them in place
+struct ChunkFormatEntity
+{
+    std::uint16_t index{};
+    BlockID block{};
+
+    // Range within the entity data section
+    std::uint32_t dataOffset{};
+    std::uint32_t dataSize{};
+    std::uint32_t reserved{};
+};
+
+static_assert(std::is_trivially_copyable_v<ChunkFormatHeader> && sizeof(ChunkFormatHeader) % ChunkFormatConstants::alignment == 0);
+static_assert(std::is_trivially_copyable_v<ChunkFormatEntity> && sizeof(ChunkFormatEntity) % ChunkFormatConstants::alignment == 0);
+
+// A block entity read in place, the data points into the viewed buffer
+struct BlockEntityView
+{
+    BlockID block{};
+    std::span<const std::uint8_t> data{};
+};
+
+/*
+    Read-only access to a serialized chunk without unpacking it.
+
+    Opening checks the header and every section bound once, after that each accessor is a
+    pointer into the buffer: the palette, counts and packed indices are the same arrays
+    PaletteStorage holds in memory. The buffer has to stay alive and 8-byte aligned, which
+    memory-mapped files and ChunkFormat::serialize output both are.
+*/
+class ChunkView
+{
+public:
+    // Empty when the buffer isn't a valid chunk of this format version; unknown block ids are kept as stored
+    static std::optional<ChunkView> open(std::span<const std::byte> bytes);
+
+    ChunkCoord getCoord() const;
+    std::size_t getSize() const;
+
+    // VoxelLayout id the packed indices were written in
+    std::uint8_t getLayout() const;
+
+    int getBitsPerEntry() const;
+    bool isUniform() const;
+    BlockID getUniformBlock() const;
+
+    // Voxel access using local coordinates, decodes only the one index
+    BlockID getBlock(int x, int y, int z) const;
+
+    std::span<const BlockID> getPalette() const;
+    std::span<const std::uint16_t> getCounts() const;
+    std::span<const std::uint64_t> getIndexWords() const;
+
+    // Reserved for light levels, empty until the engine stores light per chunk
+    std::span<const std::uint8_t> getLight() const;
+
+    std::size_t getBlockEntityCount() const;
+
+    // Index is Coordinates::localToIndex
+    std::optional<BlockEntityView> findBlockEntity(int index) const;
+
+    // fn(int index, const BlockEntityView& entity) in ascending index order
+    template <typename Fn>
+    void forEachBlockEntity(Fn&& fn) const
+    {
+        for (const ChunkFormatEntity& entity : m_entities)
+            fn(static_cast<int>(entity.index), BlockEntityView{ entity.block, m_entityData.subspan(entity.dataOffset, entity.dataSize) });
+    }
+
+private:
+    ChunkView() = default;
+
+    ChunkFormatHeader m_header{};
+    std::span<const BlockID> m_palette{};
+    std::span<const std::uint16_t> m_counts{};
+    std::span<const std::uint64_t> m_words{};
+    std::span<const std::uint8_t> m_light{};
+    std::span<const ChunkFormatEntity> m_entities{};
+    std::span<const std::uint8_t> m_entityData{};
+};
+
+/*
+    Zero-copy chunk format for disk and network.
+
+    A fixed header with the section table, then palette, palette counts, packed indices, light
+    and block entities, each section aligned to 8 bytes. Integers are in host byte order.
+*/
+namespace ChunkFormat
+{
+    std::vector<std::byte> serialize(const Chunk& chunk);
+
+    /*
+        Copies the view's sections into the chunk's storage as they are, stored counts included, false
+        when they don't check out. Unregistered ids, from a build with more block types, load as air.
+    */
+    bool load(const ChunkView& view, Chunk& chunk);
+}
+
+#endif // !CHUNK_FORMAT_H
@@ -0,0 +1,63 @@
+#ifndef CHUNK_ITERATORS_H
+#define CHUNK_ITERATORS_H
+
+#include <array>
+
+#include "Block.h"
+#include "Chunk.h"
+#include "ChunkPool.h"
+#include "Coordinates.h"
+#include "VoxelLayout.h"
+
+/*
+    Layout-agnostic traversal over a chunk.
+
+    Both visitors decode the chunk once and then walk the buffer in storage order, so
+    consecutive calls touch neighbouring memory whichever layout ChunkLayout picks.
+*/
+namespace ChunkIterators
+{
+    // fn(LocalPos position, BlockID block)
+    template <typename Fn>
+    void forEachVoxel(const Chunk& chunk, Fn&& fn)
+    {
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+        chunk.getStorage().decode(blocks);
+
+        for (int index{ 0 }; index < ChunkConstants::volume; ++index)
+            fn(ChunkLayout::position(index), blocks[index]);
+    }
+
+    /*
+        fn(LocalPos position, BlockID block, const std::array<BlockID, Faces::count>& neighbours)
+
+        Neighbours follow Faces::Face order. Neighbours outside the chunk read as outside,
+        use a ChunkSnapshot when border voxels need the real neighbouring blocks.
+    */
+    template <typename Fn>
+    void forEachNeighbourhood(const Chunk& chunk, Fn&& fn, BlockID outside = Blocks::air)
+    {
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+        chunk.getStorage().decode(blocks);
+
+        std::array<BlockID, Faces::count> neighbours{};
+        for (int index{ 0 }; index < ChunkConstants::volume; ++index)
+        {
+            const LocalPos pos{ ChunkLayout::position(index) };
+            for (int face{ 0 }; face < Faces::count; ++face)
+            {
+                const int x{ pos.x + Faces::offsets[face].x };
+                const int y{ pos.y + Faces::offsets[face].y };
+                const int z{ pos.z + Faces::offsets[face].z };
+
+                // Casting to unsigned folds the < 0 and >= size checks into one compare
+                const bool inside{ static_cast<unsigned>(x | y | z) < static_cast<unsigned>(ChunkConstants::size) };
+                neighbours[face] = inside ? blocks[ChunkLayout::index(x, y, z)] : outside;
+            }
+
+            fn(pos, blocks[index], neighbours);
+        }
+    }
+}
+
+#endif // !CHUNK_ITERATORS_H
@@ -0,0 +1,578 @@
+#include "ChunkMesher.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "ChunkOccupancy.h"
+#include "ChunkSnapshot.h"
+#include "Coordinates.h"
+
+// === Helper Functions === //
+namespace
+{
+    using namespace MeshConstants;
+
+    // Quad corners as (u, v) steps along the face's tangent axes, wound counter-clockwise seen from outside
+    struct FaceInfo
+    {
+        int axis{};
+        int side{};
+        int uAxis{};
+        int vAxis{};
+        float normal[3]{};
+        int corners[4][2]{};
+    };
+
+    // In Faces::Face order, v runs along y on the side faces so textures stay upright
+    constexpr FaceInfo faceInfos[Faces::count]{
+        { 0, 1, 2, 1, { 1.0f, 0.0f, 0.0f }, { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } } },
+        { 0, 0, 2, 1, { -1.0f, 0.0f, 0.0f }, { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } },
+        { 1, 1, 0, 2, { 0.0f, 1.0f, 0.0f }, { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } } },
+        { 1, 0, 0, 2, { 0.0f, -1.0f, 0.0f }, { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } },
+        { 2, 1, 0, 1, { 0.0f, 0.0f, 1.0f }, { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } },
+        { 2, 0, 0, 1, { 0.0f, 0.0f, -1.0f }, { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } } },
+    };
+
+    // Two triangles sharing the first and third corner
+    constexpr int triangleCorners[verticesPerFace]{ 0, 1, 2, 0, 2, 3 };
+
+    // Step to the face neighbour within the padded snapshot buffer
+    constexpr int neighbourOffset(int face)
+    {
+        const LocalPos& offset{ Faces::offsets[face] };
+        return ChunkSnapshot::index(offset.x, offset.y, offset.z) - ChunkSnapshot::index(0, 0, 0);
+    }
+
+    constexpr int neighbourOffsets[Faces::count]{
+        neighbourOffset(Faces::posX), neighbourOffset(Faces::negX), neighbourOffset(Faces::posY),
+        neighbourOffset(Faces::negY), neighbourOffset(Faces::posZ), neighbourOffset(Faces::negZ),
+    };
+
+    // Step along one axis of the padded snapshot buffer, axes ordered x, y, z
+    constexpr int axisStrides[3]{ 1, SnapshotConstants::paddedArea, SnapshotConstants::padded };
+
+    using OccupancyConstants::Column;
+
+    // OR of the occupancy columns in each row along x (indexed z) and along z (indexed x), bit y set when the row holds a voxel
+    struct ColumnUnions
+    {
+        std::array<Column, ChunkConstants::size> alongX{};
+        std::array<Column, ChunkConstants::size> alongZ{};
+    };
+
+    ColumnUnions unionColumns(const ChunkOccupancy& occupancy)
+    {
+        ColumnUnions unions{};
+        for (int z{ 0 }; z < ChunkConstants::size; ++z)
+        {
+            for (int x{ 0 }; x < ChunkConstants::size; ++x)
+            {
+                const Column column{ occupancy.getColumn(x, z) };
+                unions.alongX[z] |= column;
+                unions.alongZ[x] |= column;
+            }
+        }
+
+        return unions;
+    }
+
+    // Bit v set when row v of the slice holds a voxel, v being each face's vAxis: y for x and z faces, z for y faces
+    Column occupiedRows(const ColumnUnions& unions, int axis, int slice)
+    {
+        if (axis == 0)
+            return unions.alongZ[slice];
+        if (axis == 2)
+            return unions.alongX[slice];
+
+        Column rows{ 0 };
+        for (int z{ 0 }; z < ChunkConstants::size; ++z)
+            rows |= ((unions.alongX[z] >> slice) & 1) << z;
+
+        return rows;
+    }
+
+    // Visible faces of one slice, the block owning each face or air, indexed v * size + u
+    using FaceMask = std::array<BlockID, ChunkConstants::area>;
+
+    /*
+        One block's voxels as bit rows over the padded snapshot, the apron included so faces on the
+        chunk border see their neighbours. Rows along x are indexed (y + 1) * padded + (z + 1) with
+        bit x, rows along z (x + 1) * size + y with bit z.
+    */
+    struct BlockPlanes
+    {
+        BlockID block{};
+
+        // Bit per x, y and z holding the block inside the chunk, so slices without it are never scanned
+        std::uint32_t xs{};
+        std::uint32_t ys{};
+        std::uint32_t zs{};
+
+        std::array<std::uint32_t, SnapshotConstants::paddedArea> alongX{};
+        std::array<std::uint32_t, SnapshotConstants::padded * ChunkConstants::size> alongZ{};
+    };
+
+    // Kept per thread and reused, so meshing allocates nothing once a worker has seen its first few blocks
+    struct BinaryScratch
+    {
+        // Index + 1 of each registered block's planes, 0 while it has none
+        std::array<std::uint16_t, BlockRegistry::count> slots{};
+        std::vector<BlockPlanes> planes{};
+        std::size_t used{ 0 };
+
+        // Voxels of every opaque block, they hide any face against them
+        BlockPlanes opaque{};
+    };
+
+    // Zeroes only the planes the last chunk used
+    void clearScratch(BinaryScratch& scratch)
+    {
+        for (std::size_t i{ 0 }; i < scratch.used; ++i)
+        {
+            if (BlockRegistry::isKnown(scratch.planes[i].block))
+                scratch.slots[scratch.planes[i].block] = 0;
+            scratch.planes[i] = BlockPlanes{};
+        }
+
+        scratch.used = 0;
+        scratch.opaque = BlockPlanes{};
+    }
+
+    std::size_t slotFor(BinaryScratch& scratch, BlockID block)
+    {
+        // Unregistered ids have no table entry but still mesh, so they're searched for among the planes
+        if (BlockRegistry::isKnown(block))
+        {
+            if (scratch.slots[block] != 0)
+                return scratch.slots[block] - 1u;
+        }
+        else
+        {
+            for (std::size_t i{ 0 }; i < scratch.used; ++i)
+            {
+                if (scratch.planes[i].block == block)
+                    return i;
+            }
+        }
+
+        if (scratch.used == scratch.planes.size())
+            scratch.planes.emplace_back();
+
+        const std::size_t slot{ scratch.used++ };
+        scratch.planes[slot].block = block;
+        if (BlockRegistry::isKnown(block))
+            scratch.slots[block] = static_cast<std::uint16_t>(slot + 1);
+
+        return slot;
+    }
+
+    /*
+        Sorts the occupied voxels of one 32 voxel row into their blocks' planes, row picking the
+        word each block's bits go to. A run of one block goes in with a single OR.
+    */
+    template <typename Row>
+    void splitRow(BinaryScratch& scratch, const BlockID* voxels, int stride, std::uint32_t occupied, Row row)
+    {
+        BlockID current{ Blocks::air };
+        std::uint32_t bits{ 0 };
+        while (occupied != 0)
+        {
+            const int i{ std::countr_zero(occupied) };
+            occupied &= occupied - 1;
+
+            const BlockID block{ voxels[i * stride] };
+            if (block != current)
+            {
+                if (bits != 0 && current != Blocks::air)
+                    row(scratch.planes[slotFor(scratch, current)]) |= bits;
+
+                current = block;
+                bits = 0;
+            }
+            bits |= std::uint32_t{ 1 } << i;
+        }
+
+        if (bits != 0 && current != Blocks::air)
+            row(scratch.planes[slotFor(scratch, current)]) |= bits;
+    }
+
+    std::uint32_t occupiedBits(const BlockID* voxels, int stride)
+    {
+        std::uint32_t occupied{ 0 };
+        for (int i{ 0 }; i < ChunkConstants::size; ++i)
+            occupied |= static_cast<std::uint32_t>(voxels[i * stride] != Blocks::air) << i;
+
+        return occupied;
+    }
+
+    // In place, bit j of rows[i] trades with bit i of rows[j]: half blocks swap first, then quarters, down to single bits
+    void transpose(std::array<std::uint32_t, ChunkConstants::size>& rows)
+    {
+        std::uint32_t mask{ 0x0000FFFFu };
+        for (int width{ ChunkConstants::size / 2 }; width != 0; width >>= 1, mask ^= mask << width)
+        {
+            for (int i{ 0 }; i < ChunkConstants::size; i = (i + width + 1) & ~width)
+            {
+                const std::uint32_t swap{ ((rows[i] >> width) ^ rows[i + width]) & mask };
+                rows[i + width] ^= swap;
+                rows[i] ^= swap << width;
+            }
+        }
+    }
+
+    void resetMesh(ChunkMeshData& mesh)
+    {
+        mesh.vertices.clear();
+        mesh.packedVertices.clear();
+        mesh.faceInstances.clear();
+        mesh.faceCount = 0;
+    }
+
+    /*
+        Appends a width x height quad on one face of the box starting at voxel (x, y, z), width along
+        the face's u axis and height along v. Texture coordinates count blocks, so a repeating
+        texture tiles once per voxel however large the quad is.
+    */
+    void appendQuad(ChunkMeshData& mesh, int face, int x, int y, int z, int width, int height, BlockID block)
+    {
+        const FaceInfo& info{ faceInfos[face] };
+        ++mesh.faceCount;
+
+        if (mesh.format == faceInstances)
+        {
+            mesh.faceInstances.push_back(PackedFace::pack(x, y, z, face, width, height));
+            mesh.faceInstances.push_back(block);
+            return;
+        }
+
+        int origin[3]{ x, y, z };
+        origin[info.axis] += info.side;
+
+        if (mesh.format == packedVertices)
+        {
+            const std::size_t first{ mesh.packedVertices.size() };
+            mesh.packedVertices.resize(first + wordsPerFace);
+            std::uint32_t* out{ mesh.packedVertices.data() + first };
+
+            for (int corner : triangleCorners)
+            {
+                int position[3]{ origin[0], origin[1], origin[2] };
+                position[info.uAxis] += info.corners[corner][0] * width;
+                position[info.vAxis] += info.corners[corner][1] * height;
+
+                out[0] = PackedVertex::pack(position[0], position[1], position[2], face);
+                out[1] = block;
+                out += wordsPerVertex;
+            }
+            return;
+        }
+
+        const std::size_t first{ mesh.vertices.size() };
+        mesh.vertices.resize(first + floatsPerFace);
+        float* out{ mesh.vertices.data() + first };
+
+        for (int corner : triangleCorners)
+        {
+            const int u{ info.corners[corner][0] * width };
+            const int v{ info.corners[corner][1] * height };
+
+            int position[3]{ origin[0], origin[1], origin[2] };
+            position[info.uAxis] += u;
+            position[info.vAxis] += v;
+
+            out[0] = static_cast<float>(position[0]);
+            out[1] = static_cast<float>(position[1]);
+            out[2] = static_cast<float>(position[2]);
+            out[3] = info.normal[0];
+            out[4] = info.normal[1];
+            out[5] = info.normal[2];
+            out[6] = static_cast<float>(u);
+            out[7] = static_cast<float>(v);
+            out += floatsPerVertex;
+        }
+    }
+
+    // Greedy merge on bits: ctz finds a run, countr_one its width, and the rows below are tested against it with one AND
+    void mergePlane(ChunkMeshData& mesh, int face, int slice, std::array<std::uint32_t, ChunkConstants::size>& plane, BlockID block)
+    {
+        const FaceInfo& info{ faceInfos[face] };
+        for (int v{ 0 }; v < ChunkConstants::size; ++v)
+        {
+            while (plane[v] != 0)
+            {
+                const int u{ std::countr_zero(plane[v]) };
+                const int width{ std::countr_one(plane[v] >> u) };
+                const std::uint32_t run{ static_cast<std::uint32_t>(((std::uint64_t{ 1 } << width) - 1) << u) };
+
+                int height{ 1 };
+                while (v + height < ChunkConstants::size && (plane[v + height] & run) == run)
+                    plane[v + height++] &= ~run;
+                plane[v] &= ~run;
+
+                int position[3]{};
+                position[info.axis] = slice;
+                position[info.uAxis] = u;
+                position[info.vAxis] = v;
+                appendQuad(mesh, face, position[0], position[1], position[2], width, height, block);
+            }
+        }
+    }
+}
+
+// === ChunkMesher Functions === //
+void ChunkMesher::meshCulled(const ChunkSnapshot& snapshot, ChunkMeshData& mesh)
+{
+    resetMesh(mesh);
+    if (snapshot.isEmpty())
+        return;
+
+    // Rows without a voxel cost a bit test, scanning the rest beats gathering their bits one column at a time
+    const BlockID* blocks{ snapshot.data() };
+    const ColumnUnions unions{ unionColumns(snapshot.getOccupancy()) };
+    for (int y{ 0 }; y < ChunkConstants::size; ++y)
+    {
+        for (int z{ 0 }; z < ChunkConstants::size; ++z)
+        {
+            if (((unions.alongX[z] >> y) & 1) == 0)
+                continue;
+
+            const int row{ ChunkSnapshot::index(0, y, z) };
+            for (int x{ 0 }; x < ChunkConstants::size; ++x)
+            {
+                const BlockID block{ blocks[row + x] };
+                if (block == Blocks::air)
+                    continue;
+
+                for (int face{ 0 }; face < Faces::count; ++face)
+                {
+                    if (!isFaceVisible(block, blocks[row + x + neighbourOffsets[face]]))
+                        continue;
+
+                    appendQuad(mesh, face, x, y, z, 1, 1, block);
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::meshGreedy(const ChunkSnapshot& snapshot, ChunkMeshData& mesh)
+{
+    constexpr int size{ ChunkConstants::size };
+
+    resetMesh(mesh);
+    if (snapshot.isEmpty())
+        return;
+
+    const BlockID* blocks{ snapshot.data() };
+    const ColumnUnions unions{ unionColumns(snapshot.getOccupancy()) };
+    FaceMask mask{};
+
+    for (int face{ 0 }; face < Faces::count; ++face)
+    {
+        const FaceInfo& info{ faceInfos[face] };
+        const int uStride{ axisStrides[info.uAxis] };
+        const int vStride{ axisStrides[info.vAxis] };
+        const int neighbour{ neighbourOffsets[face] };
+
+        for (int slice{ 0 }; slice < size; ++slice)
+        {
+            // Faces belong to the chunk's own voxels, so slices and rows without any are skipped
+            const Column rows{ occupiedRows(unions, info.axis, slice) };
+            if (rows == 0)
+                continue;
+
+            // Mask of the slice's visible faces, each one tagged with its block so only equal faces merge
+            bool anyVisible{ false };
+            const int sliceStart{ ChunkSnapshot::index(0, 0, 0) + slice * axisStrides[info.axis] };
+            for (int v{ 0 }; v < size; ++v)
+            {
+                if (((rows >> v) & 1) == 0)
+                {
+                    std::fill_n(&mask[v * size], size, Blocks::air);
+                    continue;
+                }
+
+                const int rowStart{ sliceStart + v * vStride };
+                for (int u{ 0 }; u < size; ++u)
+                {
+                    const int index{ rowStart + u * uStride };
+                    const BlockID block{ blocks[index] };
+                    const bool visible{ isFaceVisible(block, blocks[index + neighbour]) };
+                    mask[v * size + u] = visible ? block : Blocks::air;
+                    anyVisible |= visible;
+                }
+            }
+
+            if (!anyVisible)
+                continue;
+
+            // Widest run along u first, then as many rows along v as match the whole run
+            for (int v{ 0 }; v < size; ++v)
+            {
+                for (int u{ 0 }; u < size;)
+                {
+                    const BlockID block{ mask[v * size + u] };
+                    if (block == Blocks::air)
+                    {
+                        ++u;
+                        continue;
+                    }
+
+                    int width{ 1 };
+                    while (u + width < size && mask[v * size + u + width] == block)
+                        ++width;
+
+                    int height{ 1 };
+                    for (; v + height < size; ++height)
+                    {
+                        const BlockID* row{ &mask[(v + height) * size + u] };
+                        bool matches{ true };
+                        for (int i{ 0 }; matches && i < width; ++i)
+                            matches = row[i] == block;
+
+                        if (!matches)
+                            break;
+                    }
+
+                    // Consumed faces are cleared so later rows don't emit them again
+                    for (int row{ v }; row < v + height; ++row)
+                        std::fill_n(&mask[row * size + u], width, Blocks::air);
+
+                    int position[3]{};
+                    position[info.axis] = slice;
+                    position[info.uAxis] = u;
+                    position[info.vAxis] = v;
+                    appendQuad(mesh, face, position[0], position[1], position[2], width, height, block);
+
+                    u += width;
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::meshBinary(const ChunkSnapshot& snapshot, ChunkMeshData& mesh)
+{
+    constexpr int size{ ChunkConstants::size };
+    constexpr int padded{ SnapshotConstants::padded };
+
+    resetMesh(mesh);
+    if (snapshot.isEmpty())
+        return;
+
+    thread_local BinaryScratch scratch{};
+    clearScratch(scratch);
+
+    const BlockID* blocks{ snapshot.data() };
+    const ChunkOccupancy& occupancy{ snapshot.getOccupancy() };
+
+    // Occupancy columns run along y, transposed a z layer at a time they give the rows along x, and only their voxels are read
+    std::array<std::uint32_t, size> rows{};
+    for (int z{ 0 }; z < size; ++z)
+    {
+        Column any{ 0 };
+        for (int x{ 0 }; x < size; ++x)
+        {
+            rows[x] = occupancy.getColumn(x, z);
+            any |= rows[x];
+        }
+        if (any == 0)
+            continue;
+
+        transpose(rows);
+        for (int y{ 0 }; y < size; ++y)
+        {
+            if (rows[y] != 0)
+                splitRow(scratch, blocks + ChunkSnapshot::index(0, y, z), 1, rows[y], [&](BlockPlanes& planes) -> std::uint32_t& { return planes.alongX[(y + 1) * padded + z + 1]; });
+        }
+    }
+
+    // The apron has no occupancy, so its six sides are scanned; edges and corners aren't next to any face of the chunk
+    for (int i{ 0 }; i < size; ++i)
+    {
+        for (const int side : { -1, size })
+        {
+            const BlockID* alongY{ blocks + ChunkSnapshot::index(0, side, i) };
+            splitRow(scratch, alongY, 1, occupiedBits(alongY, 1), [&](BlockPlanes& planes) -> std::uint32_t& { return planes.alongX[(side + 1) * padded + i + 1]; });
+
+            const BlockID* alongZ{ blocks + ChunkSnapshot::index(0, i, side) };
+            splitRow(scratch, alongZ, 1, occupiedBits(alongZ, 1), [&](BlockPlanes& planes) -> std::uint32_t& { return planes.alongX[(i + 1) * padded + side + 1]; });
+
+            const BlockID* alongX{ blocks + ChunkSnapshot::index(side, i, 0) };
+            splitRow(scratch, alongX, padded, occupiedBits(alongX, padded), [&](BlockPlanes& planes) -> std::uint32_t& { return planes.alongZ[(side + 1) * size + i]; });
+        }
+    }
+
+    // Rows along z are each y layer of the rows along x transposed, opaque blocks are ORed into one set of planes
+    for (std::size_t i{ 0 }; i < scratch.used; ++i)
+    {
+        BlockPlanes& planes{ scratch.planes[i] };
+        for (int y{ 0 }; y < size; ++y)
+        {
+            std::copy_n(&planes.alongX[(y + 1) * padded + 1], size, rows.begin());
+
+            Column any{ 0 };
+            for (int z{ 0 }; z < size; ++z)
+            {
+                if (rows[z] != 0)
+                    planes.zs |= Column{ 1 } << z;
+                any |= rows[z];
+            }
+            if (any == 0)
+                continue;
+
+            planes.xs |= any;
+            planes.ys |= Column{ 1 } << y;
+            transpose(rows);
+            for (int x{ 0 }; x < size; ++x)
+                planes.alongZ[(x + 1) * size + y] = rows[x];
+        }
+
+        if (!BlockRegistry::isOpaque(planes.block))
+            continue;
+
+        for (std::size_t j{ 0 }; j < planes.alongX.size(); ++j)
+            scratch.opaque.alongX[j] |= planes.alongX[j];
+        for (std::size_t j{ 0 }; j < planes.alongZ.size(); ++j)
+            scratch.opaque.alongZ[j] |= planes.alongZ[j];
+    }
+
+    // A block's faces are its voxels whose neighbour is neither opaque nor the same block, a whole row per AND
+    std::array<std::uint32_t, size> plane{};
+    for (std::size_t i{ 0 }; i < scratch.used; ++i)
+    {
+        const BlockPlanes& planes{ scratch.planes[i] };
+        for (int face{ 0 }; face < Faces::count; ++face)
+        {
+            const FaceInfo& info{ faceInfos[face] };
+
+            // Faces along x read the rows along z, the rest the rows along x, see BlockPlanes for the indexing
+            const bool alongZ{ info.axis == 0 };
+            const std::uint32_t* own{ alongZ ? planes.alongZ.data() : planes.alongX.data() };
+            const std::uint32_t* opaque{ alongZ ? scratch.opaque.alongZ.data() : scratch.opaque.alongX.data() };
+            const int start{ alongZ ? size : padded + 1 };
+            const int sliceStride{ info.axis == 0 ? size : info.axis == 1 ? padded : 1 };
+            const int vStride{ info.axis == 2 ? padded : 1 };
+            const int neighbour{ info.side != 0 ? sliceStride : -sliceStride };
+
+            for (Column slices{ info.axis == 0 ? planes.xs : info.axis == 1 ? planes.ys : planes.zs }; slices != 0; slices &= slices - 1)
+            {
+                const int slice{ std::countr_zero(slices) };
+                const int sliceStart{ start + slice * sliceStride };
+
+                Column any{ 0 };
+                for (int v{ 0 }; v < size; ++v)
+                {
+                    const int index{ sliceStart + v * vStride };
+                    plane[v] = own[index] & ~(opaque[index + neighbour] | own[index + neighbour]);
+                    any |= plane[v];
+                }
+
+                if (any != 0)
+                    mergePlane(mesh, face, slice, plane, planes.block);
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Block.h"
+#include "BlockRegistry.h"
+
+class ChunkSnapshot;
+
+namespace MeshConstants
+{
+    // Position, normal and texture coordinate, the layout lightingVert.glsl reads
+    inline constexpr int floatsPerVertex{ 8 };
+
+    // Two triangles, drawn with glDrawArrays like the rest of the renderer
+    inline constexpr int verticesPerFace{ 6 };
+    inline constexpr int floatsPerFace{ floatsPerVertex * verticesPerFace };
+
+    // Packed layout, two 32-bit words per vertex read as integer attributes by chunkVert.glsl
+    inline constexpr int wordsPerVertex{ 2 };
+    inline constexpr int wordsPerFace{ wordsPerVertex * verticesPerFace };
+
+    // Instanced layout, two 32-bit words per face expanded into a quad by chunkInstanceVert.glsl
+    inline constexpr int wordsPerInstance{ 2 };
+
+    enum VertexFormat
+    {
+        floatVertices,
+        packedVertices,
+        faceInstances,
+    };
+
+}
+
+/*
+    Packed vertex, 8 bytes instead of 32. Word 0 holds the corner's chunk-local position in 6 bits
+    per axis, corners run from 0 to 32, then the Faces::Face in 3 bits; the 11 bits above are spare for
+    ambient occlusion and light. Word 1 holds the block id, the texture layer once blocks get
+    their own textures. The shader derives normal and texture coordinates from face and position.
+*/
+namespace PackedVertex
+{
+    inline constexpr int positionBits{ 6 };
+    inline constexpr int faceShift{ 3 * positionBits };
+
+    inline constexpr std::uint32_t pack(int x, int y, int z, int face)
+    {
+        return static_cast<std::uint32_t>(x | y << positionBits | z << (2 * positionBits) | face << faceShift);
+    }
+}
+
+/*
+    Face instance, one record per quad instead of six vertices. Word 0 holds the quad's first voxel
+    in 5 bits per axis, the Faces::Face in 3 bits, then width and height minus one in 5 bits each; the
+    top 4 bits are spare. Word 1 holds the block id like the packed vertex. The shader expands
+    the record into the quad's two triangles from gl_VertexID.
+*/
+namespace PackedFace
+{
+    inline constexpr int positionBits{ 5 };
+    inline constexpr int faceShift{ 3 * positionBits };
+    inline constexpr int widthShift{ faceShift + 3 };
+    inline constexpr int heightShift{ widthShift + positionBits };
+
+    inline constexpr std::uint32_t pack(int x, int y, int z, int face, int width, int height)
+    {
+        return static_cast<std::uint32_t>(x | y << positionBits | z << (2 * positionBits) | face << faceShift
+            | (width - 1) << widthShift | (height - 1) << heightShift);
+    }
+}
+
+// Vertices in chunk-local block units, the chunk's corner is the origin; set format before meshing
+struct ChunkMeshData
+{
+    MeshConstants::VertexFormat format{ MeshConstants::floatVertices };
+    std::vector<float> vertices{};
+    std::vector<std::uint32_t> packedVertices{};
+    std::vector<std::uint32_t> faceInstances{};
+    std::size_t faceCount{};
+
+    // Vertices the GPU runs, instanced faces still expand to six each
+    std::size_t getVertexCount() const
+    {
+        if (format == MeshConstants::faceInstances)
+            return faceCount * MeshConstants::verticesPerFace;
+        if (format == MeshConstants::packedVertices)
+            return packedVertices.size() / MeshConstants::wordsPerVertex;
+
+        return vertices.size() / MeshConstants::floatsPerVertex;
+    }
+};
+
+/*
+    CPU meshing of one chunk snapshot into triangles ready for a VBO.
+
+    Only faces that can be seen are emitted, so a solid chunk produces a shell instead of
+    36 vertices per block. The snapshot's apron decides the faces on the chunk border.
+    faceCount counts quads, which after greedy merging can each cover many voxel faces.
+*/
+namespace ChunkMesher
+{
+    // A face shows when the neighbour doesn't hide it: not opaque, and not the same transparent block
+    inline constexpr bool isFaceVisible(BlockID block, BlockID neighbour)
+    {
+        return block != Blocks::air && neighbour != block && !BlockRegistry::isOpaque(neighbour);
+    }
+
+    // One quad per visible voxel face. Clears and refills mesh, so one buffer can serve many chunks without reallocating
+    void meshCulled(const ChunkSnapshot& snapshot, ChunkMeshData& mesh);
+
+    /*
+        Same visible faces, merged slice by slice into maximal rectangles of one block. Texture
+        coordinates count blocks across the merged quad, so GL_REPEAT tiles the texture exactly
+        as the per-voxel faces would.
+    */
+    void meshGreedy(const ChunkSnapshot& snapshot, ChunkMeshData& mesh);
+
+    /*
+        Produces the same quads as meshGreedy with bit operations instead of per-voxel compares.
+        The chunk's occupancy columns pick out the voxels to read, which are split into 32-bit rows
+        per block in a reused per-thread buffer. A block's faces drop out of a whole row with one
+        AND against the opaque and same-block rows beside it, and merging walks them with ctz.
+    */
+    void meshBinary(const ChunkSnapshot& snapshot, ChunkMeshData& mesh);
+}
+
+#endif // !CHUNK_MESHER_H
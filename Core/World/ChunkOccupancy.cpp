@@ -0,0 +1,160 @@
+#include "ChunkOccupancy.h"
+
+#include <algorithm>
+#include <bit>
+
+// === Helper Functions === //
+namespace
+{
+    using OccupancyConstants::brickSize;
+    using OccupancyConstants::brickSizeLog2;
+    using OccupancyConstants::Column;
+
+    // Bits first through last of a column, inclusive
+    constexpr Column columnRange(int first, int last)
+    {
+        const std::uint64_t bits{ (std::uint64_t{ 2 } << last) - (std::uint64_t{ 1 } << first) };
+        return static_cast<Column>(bits);
+    }
+
+    constexpr Column brickMask{ columnRange(0, brickSize - 1) };
+}
+
+// === ChunkOccupancy Class === //
+ChunkOccupancy::ChunkOccupancy(bool occupied)
+{
+    if (!occupied)
+        return;
+
+    m_columns.fill(~Column{ 0 });
+    m_brickLayers.fill(~std::uint64_t{ 0 });
+}
+
+const ChunkOccupancy& ChunkOccupancy::uniform(bool occupied)
+{
+    static const ChunkOccupancy empty{ false };
+    static const ChunkOccupancy full{ true };
+    return occupied ? full : empty;
+}
+
+void ChunkOccupancy::build(std::span<const BlockID> blocks)
+{
+    m_columns.fill(0);
+    m_brickLayers.fill(0);
+
+    for (int y{ 0 }; y < ChunkConstants::size; ++y)
+    {
+        for (int z{ 0 }; z < ChunkConstants::size; ++z)
+        {
+            const BlockID* row{ &blocks[Coordinates::localToIndex(0, y, z)] };
+            for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                m_columns[columnIndex(x, z)] |= static_cast<Column>(row[x] != Blocks::air) << y;
+        }
+    }
+
+    for (int z{ 0 }; z < ChunkConstants::size; ++z)
+    {
+        for (int x{ 0 }; x < ChunkConstants::size; ++x)
+        {
+            const Column column{ m_columns[columnIndex(x, z)] };
+            for (int by{ 0 }; by < OccupancyConstants::bricksPerAxis; ++by)
+            {
+                if ((column >> (by << brickSizeLog2)) & brickMask)
+                    m_brickLayers[by] |= std::uint64_t{ 1 } << brickBit(x >> brickSizeLog2, z >> brickSizeLog2);
+            }
+        }
+    }
+}
+
+void ChunkOccupancy::set(int x, int y, int z, bool occupied)
+{
+    Column& column{ m_columns[columnIndex(x, z)] };
+    const Column bit{ Column{ 1 } << y };
+    if (((column & bit) != 0) == occupied)
+        return;
+
+    column ^= bit;
+
+    const int bx{ x >> brickSizeLog2 };
+    const int by{ y >> brickSizeLog2 };
+    const int bz{ z >> brickSizeLog2 };
+    if (occupied)
+        m_brickLayers[by] |= std::uint64_t{ 1 } << brickBit(bx, bz);
+    else
+        refreshBrick(bx, by, bz);
+}
+
+bool ChunkOccupancy::test(int x, int y, int z) const
+{
+    return (m_columns[columnIndex(x, z)] >> y) & 1;
+}
+
+OccupancyConstants::Column ChunkOccupancy::getColumn(int x, int z) const
+{
+    return m_columns[columnIndex(x, z)];
+}
+
+bool ChunkOccupancy::isBrickOccupied(int bx, int by, int bz) const
+{
+    return (m_brickLayers[by] >> brickBit(bx, bz)) & 1;
+}
+
+bool ChunkOccupancy::isBoxEmpty(const LocalBox& box) const
+{
+    const Column yMask{ columnRange(box.min.y, box.max.y) };
+
+    for (int bz{ box.min.z >> brickSizeLog2 }; bz <= box.max.z >> brickSizeLog2; ++bz)
+    {
+        for (int bx{ box.min.x >> brickSizeLog2 }; bx <= box.max.x >> brickSizeLog2; ++bx)
+        {
+            bool brickColumnOccupied{ false };
+            for (int by{ box.min.y >> brickSizeLog2 }; by <= box.max.y >> brickSizeLog2; ++by)
+                brickColumnOccupied |= isBrickOccupied(bx, by, bz);
+
+            if (!brickColumnOccupied)
+                continue;
+
+            // Only the columns of this brick that the box covers
+            const int zEnd{ std::min(box.max.z, (bz << brickSizeLog2) + brickSize - 1) };
+            const int xEnd{ std::min(box.max.x, (bx << brickSizeLog2) + brickSize - 1) };
+            for (int z{ std::max(box.min.z, bz << brickSizeLog2) }; z <= zEnd; ++z)
+            {
+                for (int x{ std::max(box.min.x, bx << brickSizeLog2) }; x <= xEnd; ++x)
+                {
+                    if (m_columns[columnIndex(x, z)] & yMask)
+                        return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ChunkOccupancy::isEmpty() const
+{
+    return std::all_of(m_brickLayers.begin(), m_brickLayers.end(), [](std::uint64_t layer) { return layer == 0; });
+}
+
+std::size_t ChunkOccupancy::getOccupiedCount() const
+{
+    std::size_t count{ 0 };
+    for (Column column : m_columns)
+        count += static_cast<std::size_t>(std::popcount(column));
+
+    return count;
+}
+
+void ChunkOccupancy::refreshBrick(int bx, int by, int bz)
+{
+    Column occupied{ 0 };
+    for (int z{ bz << brickSizeLog2 }; z < (bz << brickSizeLog2) + brickSize; ++z)
+        for (int x{ bx << brickSizeLog2 }; x < (bx << brickSizeLog2) + brickSize; ++x)
+            occupied |= m_columns[columnIndex(x, z)];
+
+    const std::uint64_t bit{ std::uint64_t{ 1 } << brickBit(bx, bz) };
+    if ((occupied >> (by << brickSizeLog2)) & brickMask)
+        m_brickLayers[by] |= bit;
+    else
+        m_brickLayers[by] &= ~bit;
+}
@@ -0,0 +1,79 @@
+#ifndef CHUNK_OCCUPANCY_H
+#define CHUNK_OCCUPANCY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Block.h"
+#include "Coordinates.h"
+
+namespace OccupancyConstants
+{
+    // Bricks are 4^3 voxels, 8 per chunk axis
+    inline constexpr int brickSizeLog2{ 2 };
+    inline constexpr int brickSize{ 1 << brickSizeLog2 };
+    inline constexpr int bricksPerAxis{ ChunkConstants::size / brickSize };
+
+    // A column holds one bit per voxel along y, 32 tall chunks fit a 32-bit word exactly
+    using Column = std::uint32_t;
+    static_assert(sizeof(Column) * 8 == ChunkConstants::size, "One occupancy bit per voxel of a column");
+}
+
+/*
+    Which voxels of a chunk hold anything but air, at two levels.
+
+    Voxel level keeps one bit per voxel in a word per y column, brick level one bit per 4^3 brick
+    in a 64-bit word per brick layer. Empty space is skipped a brick or a column at a time with
+    plain word compares, popcount and ctz instead of decoding blocks.
+*/
+class ChunkOccupancy
+{
+public:
+    // Constructor, every voxel starts empty
+    ChunkOccupancy() = default;
+
+    // Shared instances for uniform chunks, which never allocate their own
+    static const ChunkOccupancy& uniform(bool occupied);
+
+    // Rebuilds from a flat array indexed by Coordinates::localToIndex
+    void build(std::span<const BlockID> blocks);
+
+    void set(int x, int y, int z, bool occupied);
+    bool test(int x, int y, int z) const;
+
+    // Bit y is set when voxel (x, y, z) is occupied
+    OccupancyConstants::Column getColumn(int x, int z) const;
+
+    // Brick coordinates are local coordinates divided by the brick size
+    bool isBrickOccupied(int bx, int by, int bz) const;
+
+    // Tests bricks first and only looks at columns inside occupied bricks
+    bool isBoxEmpty(const LocalBox& box) const;
+
+    bool isEmpty() const;
+    std::size_t getOccupiedCount() const;
+
+private:
+    explicit ChunkOccupancy(bool occupied);
+
+    static constexpr int columnIndex(int x, int z)
+    {
+        return z * ChunkConstants::size + x;
+    }
+
+    // Brick bit within its layer word
+    static constexpr int brickBit(int bx, int bz)
+    {
+        return bz * OccupancyConstants::bricksPerAxis + bx;
+    }
+
+    // Recomputes one brick bit from the columns under it
+    void refreshBrick(int bx, int by, int bz);
+
+    std::array<OccupancyConstants::Column, ChunkConstants::area> m_columns{};
+    std::array<std::uint64_t, OccupancyConstants::bricksPerAxis> m_brickLayers{};
+};
+
+#endif // !CHUNK_OCCUPANCY_H
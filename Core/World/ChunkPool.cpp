@@ -0,0 +1,277 @@
+#include "ChunkPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// === Helper Functions === //
+namespace
+{
+    // Oversize blocks and slabs without mmap are page aligned, like the 4 KiB classes inside a slab
+    constexpr std::align_val_t blockAlignment{ 4096 };
+
+    std::byte* mapSlab(bool hugePages)
+    {
+#ifdef __linux__
+        // Map twice the size and trim, huge pages need a 2 MiB aligned range
+        constexpr std::size_t mapSize{ PoolConstants::slabSize * 2 };
+        void* mapped{ mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+        if (mapped == MAP_FAILED)
+            throw std::bad_alloc{};
+
+        auto* begin{ static_cast<std::byte*>(mapped) };
+        const auto address{ reinterpret_cast<std::uintptr_t>(begin) };
+        const std::size_t head{ (PoolConstants::slabSize - address % PoolConstants::slabSize) % PoolConstants::slabSize };
+        std::byte* slab{ begin + head };
+
+        if (head != 0)
+            munmap(begin, head);
+        munmap(slab + PoolConstants::slabSize, mapSize - head - PoolConstants::slabSize);
+
+        if (hugePages)
+            madvise(slab, PoolConstants::slabSize, MADV_HUGEPAGE);
+
+        return slab;
+#else
+        (void)hugePages;
+        return static_cast<std::byte*>(::operator new(PoolConstants::slabSize, blockAlignment));
+#endif
+    }
+
+    void unmapSlab(std::byte* slab)
+    {
+#ifdef __linux__
+        munmap(slab, PoolConstants::slabSize);
+#else
+        ::operator delete(slab, blockAlignment);
+#endif
+    }
+}
+
+// === ChunkPool Class === //
+// Trivially destructible, so buffers freed by destructors running late in thread exit still find it
+struct ChunkPool::ThreadCache
+{
+    std::array<std::array<void*, PoolConstants::threadCacheBlocks>, PoolConstants::classCount> blocks{};
+    std::array<int, PoolConstants::classCount> counts{};
+
+    // Set once the thread's blocks went back, later calls go straight to the shared lists
+    bool retired{ false };
+};
+
+ChunkPool& ChunkPool::instance()
+{
+    // Never destroyed, chunks owned by other statics may still free blocks during shutdown
+    static ChunkPool* pool{ new ChunkPool{} };
+    return *pool;
+}
+
+ChunkPool::~ChunkPool()
+{
+    for (const Slab& slab : m_slabs)
+        unmapSlab(slab.memory);
+}
+
+void* ChunkPool::allocate(std::size_t bytes)
+{
+    const int sizeClass{ classFor(bytes) };
+    if (sizeClass < 0)
+    {
+        std::scoped_lock lock{ m_mutex };
+        ++m_oversize;
+        return ::operator new(bytes, blockAlignment);
+    }
+
+    ThreadCache& cache{ threadCache() };
+    if (cache.retired)
+    {
+        void* block{};
+        takeBlocks(sizeClass, &block, 1);
+        return block;
+    }
+
+    int& count{ cache.counts[sizeClass] };
+    if (count == 0)
+        count = takeBlocks(sizeClass, cache.blocks[sizeClass].data(), PoolConstants::threadCacheBlocks / 2);
+
+    return cache.blocks[sizeClass][--count];
+}
+
+void ChunkPool::deallocate(void* block, std::size_t bytes)
+{
+    if (!block)
+        return;
+
+    const int sizeClass{ classFor(bytes) };
+    if (sizeClass < 0)
+    {
+        std::scoped_lock lock{ m_mutex };
+        --m_oversize;
+        ::operator delete(block, blockAlignment);
+        return;
+    }
+
+    ThreadCache& cache{ threadCache() };
+    if (cache.retired)
+    {
+        returnBlocks(sizeClass, &block, 1);
+        return;
+    }
+
+    // A full cache hands its older half back, keeping the recently used blocks warm
+    int& count{ cache.counts[sizeClass] };
+    if (count == PoolConstants::threadCacheBlocks)
+    {
+        constexpr int half{ PoolConstants::threadCacheBlocks / 2 };
+        void** blocks{ cache.blocks[sizeClass].data() };
+        returnBlocks(sizeClass, blocks, half);
+        std::copy(blocks + half, blocks + count, blocks);
+        count -= half;
+    }
+
+    cache.blocks[sizeClass][count++] = block;
+}
+
+void ChunkPool::setHugePages(bool enable)
+{
+    std::scoped_lock lock{ m_mutex };
+    m_hugePages = enable;
+}
+
+PoolStats ChunkPool::getStats() const
+{
+    std::scoped_lock lock{ m_mutex };
+
+    PoolStats stats{};
+    for (int sizeClass{ 0 }; sizeClass < PoolConstants::classCount; ++sizeClass)
+    {
+        stats.classes[sizeClass].blockSize = classSize(sizeClass);
+        stats.classes[sizeClass].freeBlocks = m_freeCounts[sizeClass];
+    }
+
+    for (const Slab& slab : m_slabs)
+    {
+        PoolClassStats& classStats{ stats.classes[slab.sizeClass] };
+        ++classStats.slabs;
+        classStats.liveBlocks += slab.liveBlocks;
+        if (slab.liveBlocks == 0)
+            ++stats.freeSlabs;
+    }
+
+    stats.oversizeAllocations = m_oversize;
+    return stats;
+}
+
+int ChunkPool::classFor(std::size_t bytes)
+{
+    for (int sizeClass{ 0 }; sizeClass < PoolConstants::classCount; ++sizeClass)
+    {
+        if (bytes <= classSize(sizeClass))
+            return sizeClass;
+    }
+
+    return -1;
+}
+
+std::size_t ChunkPool::classSize(int sizeClass)
+{
+    return PoolConstants::smallestClass << sizeClass;
+}
+
+ChunkPool::ThreadCache& ChunkPool::threadCache()
+{
+    thread_local ThreadCache cache{};
+
+    // Hands the thread's cached blocks back to the shared lists when it exits
+    struct Drain
+    {
+        ~Drain()
+        {
+            for (int sizeClass{ 0 }; sizeClass < PoolConstants::classCount; ++sizeClass)
+            {
+                ChunkPool::instance().returnBlocks(sizeClass, cache.blocks[sizeClass].data(), cache.counts[sizeClass]);
+                cache.counts[sizeClass] = 0;
+            }
+            cache.retired = true;
+        }
+    };
+    thread_local Drain drain{};
+    (void)drain;
+
+    return cache;
+}
+
+int ChunkPool::takeBlocks(int sizeClass, void** blocks, int count)
+{
+    std::scoped_lock lock{ m_mutex };
+    if (!m_freeLists[sizeClass])
+        addSlab(sizeClass);
+
+    int taken{ 0 };
+    for (; taken < count && m_freeLists[sizeClass]; ++taken)
+    {
+        FreeBlock* block{ m_freeLists[sizeClass] };
+        m_freeLists[sizeClass] = block->next;
+        ++findSlab(block)->liveBlocks;
+        blocks[taken] = block;
+    }
+
+    m_freeCounts[sizeClass] -= taken;
+    return taken;
+}
+
+void ChunkPool::returnBlocks(int sizeClass, void* const* blocks, int count)
+{
+    std::scoped_lock lock{ m_mutex };
+    for (int i{ 0 }; i < count; ++i)
+    {
+        Slab* slab{ findSlab(blocks[i]) };
+        assert(slab && slab->sizeClass == sizeClass);
+        --slab->liveBlocks;
+
+        auto* freed{ static_cast<FreeBlock*>(blocks[i]) };
+        freed->next = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = freed;
+    }
+
+    m_freeCounts[sizeClass] += count;
+}
+
+void ChunkPool::addSlab(int sizeClass)
+{
+    std::byte* memory{ mapSlab(m_hugePages) };
+
+    auto it{ std::upper_bound(m_slabs.begin(), m_slabs.end(), memory,
+        [](const std::byte* address, const Slab& slab) { return address < slab.memory; }) };
+    m_slabs.insert(it, Slab{ memory, sizeClass, 0 });
+
+    // Push in reverse so blocks are handed out in address order
+    const std::size_t blockSize{ classSize(sizeClass) };
+    const std::size_t blockCount{ PoolConstants::slabSize / blockSize };
+    for (std::size_t i{ blockCount }; i-- > 0;)
+    {
+        auto* block{ reinterpret_cast<FreeBlock*>(memory + i * blockSize) };
+        block->next = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = block;
+    }
+
+    m_freeCounts[sizeClass] += blockCount;
+}
+
+ChunkPool::Slab* ChunkPool::findSlab(const void* block)
+{
+    const auto* address{ static_cast<const std::byte*>(block) };
+    auto it{ std::upper_bound(m_slabs.begin(), m_slabs.end(), address,
+        [](const std::byte* value, const Slab& slab) { return value < slab.memory; }) };
+
+    if (it == m_slabs.begin())
+        return nullptr;
+
+    --it;
+    return address < it->memory + PoolConstants::slabSize ? &*it : nullptr;
+}
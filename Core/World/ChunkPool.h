@@ -0,0 +1,346 @@
+#ifndef CHUNK_POOL_H
+#define CHUNK_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace PoolConstants
+{
+    // 2 MiB slabs match the x86-64 huge page size
+    inline constexpr std::size_t slabSize{ std::size_t{ 2 } << 20 };
+
+    // Chunk objects, palettes and map nodes take the classes from 64 bytes up. Packed chunk storage
+    // is 4 KiB per index bit (1, 2, 4, 8 and 16 bits), the 64 KiB class also fits a fully decoded
+    // 32^3 chunk and 128 KiB fits a padded 34^3 snapshot
+    inline constexpr std::size_t smallestClass{ 64 };
+    inline constexpr int classCount{ 12 };
+
+    // Free blocks each thread keeps per class, refilled and drained half a cache at a time
+    inline constexpr int threadCacheBlocks{ 8 };
+}
+
+struct PoolClassStats
+{
+    std::size_t blockSize{};
+    std::size_t slabs{};
+
+    // Blocks handed out of the shared free lists, including those parked in thread caches
+    std::size_t liveBlocks{};
+    std::size_t freeBlocks{};
+};
+
+struct PoolStats
+{
+    std::array<PoolClassStats, PoolConstants::classCount> classes{};
+
+    // Slabs that currently hold no live block
+    std::size_t freeSlabs{};
+
+    // Allocations too large for any class, served by the system allocator
+    std::size_t oversizeAllocations{};
+};
+
+/*
+    Slab allocator for chunks and their voxel buffers.
+
+    Each size class carves 2 MiB slabs into equal blocks and keeps freed blocks on an
+    intrusive free list. Slabs are never returned, so once the pool has warmed up, chunk
+    objects, palettes and voxel buffers are recycled without touching the system allocator.
+
+    Every thread keeps a few free blocks per class of its own, so the scratch buffers workers
+    take and drop per chunk only lock the shared lists once every few calls.
+*/
+class ChunkPool
+{
+public:
+    static ChunkPool& instance();
+
+    ~ChunkPool();
+
+    // Deleted copy and move operations, there is one pool per process
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+    ChunkPool(ChunkPool&&) = delete;
+    ChunkPool& operator=(ChunkPool&&) = delete;
+
+    // Rounds up to the smallest fitting class, pass the same byte count back to deallocate
+    void* allocate(std::size_t bytes);
+    void deallocate(void* block, std::size_t bytes);
+
+    // Backs new slabs with transparent huge pages where supported (Linux madvise), off by default
+    void setHugePages(bool enable);
+
+    PoolStats getStats() const;
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next{};
+    };
+
+    struct Slab
+    {
+        std::byte* memory{};
+        int sizeClass{};
+        std::size_t liveBlocks{};
+    };
+
+    // Defined in the source file, each thread owns one and hands its blocks back on exit
+    struct ThreadCache;
+
+    ChunkPool() = default;
+
+    static ThreadCache& threadCache();
+
+    static int classFor(std::size_t bytes);
+    static std::size_t classSize(int sizeClass);
+
+    void addSlab(int sizeClass);
+    Slab* findSlab(const void* block);
+
+    // Batch moves between a thread cache and the shared lists, both lock the mutex once
+    int takeBlocks(int sizeClass, void** blocks, int count);
+    void returnBlocks(int sizeClass, void* const* blocks, int count);
+
+    mutable std::mutex m_mutex{};
+    bool m_hugePages{ false };
+
+    std::array<FreeBlock*, PoolConstants::classCount> m_freeLists{};
+    std::array<std::size_t, PoolConstants::classCount> m_freeCounts{};
+    std::size_t m_oversize{};
+
+    // Sorted by address so a block finds its slab with a binary search
+    std::vector<Slab> m_slabs{};
+};
+
+// Fixed-size array of trivially copyable T whose memory comes from ChunkPool
+template <typename T>
+class PooledBuffer
+{
+public:
+    PooledBuffer() = default;
+
+    // Uninitialised, callers that read before writing clear it themselves
+    explicit PooledBuffer(std::size_t count)
+        : m_count{ count }
+    {
+        if (m_count != 0)
+            m_data = static_cast<T*>(ChunkPool::instance().allocate(sizeBytes()));
+    }
+
+    ~PooledBuffer()
+    {
+        release();
+    }
+
+    PooledBuffer(const PooledBuffer& other)
+        : PooledBuffer(other.m_count)
+    {
+        if (m_count != 0)
+            std::memcpy(m_data, other.m_data, sizeBytes());
+    }
+
+    PooledBuffer& operator=(const PooledBuffer& other)
+    {
+        if (this != &other)
+        {
+            PooledBuffer copy{ other };
+            swap(copy);
+        }
+        return *this;
+    }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : m_data{ std::exchange(other.m_data, nullptr) }
+        , m_count{ std::exchange(other.m_count, 0) }
+    {
+    }
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_count = std::exchange(other.m_count, 0);
+        }
+        return *this;
+    }
+
+    void swap(PooledBuffer& other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_count, other.m_count);
+    }
+
+    void release()
+    {
+        if (m_data)
+            ChunkPool::instance().deallocate(m_data, sizeBytes());
+
+        m_data = nullptr;
+        m_count = 0;
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    std::size_t size() const { return m_count; }
+    std::size_t sizeBytes() const { return m_count * sizeof(T); }
+    bool empty() const { return m_count == 0; }
+
+    T& operator[](std::size_t index) { return m_data[index]; }
+    const T& operator[](std::size_t index) const { return m_data[index]; }
+
+    operator std::span<T>() { return { m_data, m_count }; }
+    operator std::span<const T>() const { return { m_data, m_count }; }
+
+private:
+    T* m_data{};
+    std::size_t m_count{};
+};
+
+// Growable array of trivially copyable T on a PooledBuffer, for small arrays like palettes. Doubles when full
+template <typename T>
+class PooledVector
+{
+public:
+    PooledVector() = default;
+    ~PooledVector() = default;
+
+    PooledVector(const PooledVector&) = default;
+    PooledVector& operator=(const PooledVector&) = default;
+
+    // Moved-from vectors are left empty rather than sized over a null buffer
+    PooledVector(PooledVector&& other) noexcept
+        : m_buffer{ std::move(other.m_buffer) }
+        , m_size{ std::exchange(other.m_size, 0) }
+    {
+    }
+
+    PooledVector& operator=(PooledVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            m_buffer = std::move(other.m_buffer);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    void reserve(std::size_t capacity)
+    {
+        if (capacity <= m_buffer.size())
+            return;
+
+        PooledBuffer<T> grown{ capacity };
+        if (m_size != 0)
+            std::memcpy(grown.data(), m_buffer.data(), m_size * sizeof(T));
+        m_buffer.swap(grown);
+    }
+
+    void push_back(const T& value)
+    {
+        if (m_size == m_buffer.size())
+            reserve(std::max<std::size_t>(m_size * 2, 4));
+
+        m_buffer[m_size++] = value;
+    }
+
+    void resize(std::size_t count, const T& value)
+    {
+        reserve(count);
+        if (count > m_size)
+            std::fill(m_buffer.data() + m_size, m_buffer.data() + count, value);
+        m_size = count;
+    }
+
+    void assign(std::size_t count, const T& value)
+    {
+        m_size = 0;
+        resize(count, value);
+    }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        m_size = 0;
+        reserve(static_cast<std::size_t>(std::distance(first, last)));
+        m_size = static_cast<std::size_t>(std::copy(first, last, m_buffer.data()) - m_buffer.data());
+    }
+
+    // Keeps the buffer, release hands it back to the pool
+    void clear() { m_size = 0; }
+
+    void release()
+    {
+        m_buffer.release();
+        m_size = 0;
+    }
+
+    T* data() { return m_buffer.data(); }
+    const T* data() const { return m_buffer.data(); }
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_buffer.size(); }
+    bool empty() const { return m_size == 0; }
+
+    T* begin() { return data(); }
+    T* end() { return data() + m_size; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + m_size; }
+
+    T& front() { return m_buffer[0]; }
+    const T& front() const { return m_buffer[0]; }
+    T& operator[](std::size_t index) { return m_buffer[index]; }
+    const T& operator[](std::size_t index) const { return m_buffer[index]; }
+
+    operator std::span<T>() { return { data(), m_size }; }
+    operator std::span<const T>() const { return { data(), m_size }; }
+
+private:
+    PooledBuffer<T> m_buffer{};
+    std::size_t m_size{};
+};
+
+// Standard allocator over ChunkPool, for std::allocate_shared and node containers on the chunk load path
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(ChunkPool::instance().allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count)
+    {
+        ChunkPool::instance().deallocate(pointer, count * sizeof(T));
+    }
+
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) { return true; }
+};
+
+// std::make_shared with the object and its control block in one pool block
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+#endif // !CHUNK_POOL_H
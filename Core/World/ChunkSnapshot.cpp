@@ -0,0 +1,188 @@
+#include "ChunkSnapshot.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "Chunk.h"
+#include "EpochManager.h"
+#include "PaletteStorage.h"
+#include "VoxelLayout.h"
+#include "World.h"
+
+// === Helper Functions === //
+namespace
+{
+    // Source range along one axis of a neighbour offset by d chunks, the apron is one layer thick
+    struct AxisRange
+    {
+        int from{};
+        int to{};
+    };
+
+    constexpr AxisRange apronRange(int d)
+    {
+        if (d < 0)
+            return { ChunkConstants::mask, ChunkConstants::mask };
+        if (d > 0)
+            return { 0, 0 };
+        return { 0, ChunkConstants::mask };
+    }
+
+    constexpr int sourceIndex(int dx, int dy, int dz)
+    {
+        return (dy + 1) * 9 + (dz + 1) * 3 + (dx + 1);
+    }
+}
+
+// === ChunkSnapshot Class === //
+ChunkSnapshot::ChunkSnapshot(const World& world, ChunkCoord coord, BlockID outside)
+    : m_coord{ coord }
+    , m_blocks{ SnapshotConstants::paddedVolume }
+{
+    Sources sources{};
+    for (int dy{ -1 }; dy <= 1; ++dy)
+        for (int dz{ -1 }; dz <= 1; ++dz)
+            for (int dx{ -1 }; dx <= 1; ++dx)
+                if (const Chunk* chunk{ world.getChunk({ coord.x + dx, coord.y + dy, coord.z + dz }) })
+                    sources[sourceIndex(dx, dy, dz)] = &chunk->getStorage();
+
+    if (const Chunk* chunk{ world.getChunk(coord) })
+    {
+        m_version = chunk->getVersion();
+        m_occupancy = chunk->getOccupancy();
+    }
+
+    copyFrom(sources, outside);
+}
+
+ChunkSnapshot::ChunkSnapshot(const World& world, ChunkCoord coord, const EpochGuard&, BlockID outside)
+    : m_coord{ coord }
+    , m_blocks{ SnapshotConstants::paddedVolume }
+{
+    // The handles can go right away, the pinned epoch keeps the published versions alive
+    Sources sources{};
+    for (int dy{ -1 }; dy <= 1; ++dy)
+    {
+        for (int dz{ -1 }; dz <= 1; ++dz)
+        {
+            for (int dx{ -1 }; dx <= 1; ++dx)
+            {
+                const ChunkHandle chunk{ world.acquireChunk({ coord.x + dx, coord.y + dy, coord.z + dz }) };
+                const ChunkVersion* version{ chunk ? chunk->getPublished() : nullptr };
+                if (!version)
+                    continue;
+
+                sources[sourceIndex(dx, dy, dz)] = version->storage.get();
+                if (dx == 0 && dy == 0 && dz == 0)
+                {
+                    m_version = version->version;
+                    m_occupancy = *version->occupancy;
+                }
+            }
+        }
+    }
+
+    copyFrom(sources, outside);
+}
+
+BlockID ChunkSnapshot::get(int x, int y, int z) const
+{
+    return m_blocks[index(x, y, z)];
+}
+
+const BlockID* ChunkSnapshot::data() const
+{
+    return m_blocks.data();
+}
+
+ChunkCoord ChunkSnapshot::getCoord() const
+{
+    return m_coord;
+}
+
+bool ChunkSnapshot::isEmpty() const
+{
+    return m_isEmpty;
+}
+
+const ChunkOccupancy& ChunkSnapshot::getOccupancy() const
+{
+    return m_occupancy;
+}
+
+std::uint64_t ChunkSnapshot::getVersion() const
+{
+    return m_version;
+}
+
+void ChunkSnapshot::copyFrom(const Sources& sources, BlockID outside)
+{
+    using ChunkConstants::size;
+
+    // Centre: uniform chunks fill rows, others take one bulk decode copied into the padded layout
+    const PaletteStorage* centre{ sources[sourceIndex(0, 0, 0)] };
+    if (!centre || centre->isUniform())
+    {
+        // A missing chunk reads as outside, so a solid outside makes it solid rather than empty
+        const BlockID fill{ centre ? centre->getUniformBlock() : outside };
+        m_isEmpty = fill == Blocks::air;
+        if (!centre)
+            m_occupancy = ChunkOccupancy::uniform(!m_isEmpty);
+
+        for (int y{ 0 }; y < size; ++y)
+            for (int z{ 0 }; z < size; ++z)
+                std::fill_n(&m_blocks[index(0, y, z)], size, fill);
+    }
+    else
+    {
+        m_isEmpty = false;
+
+        PooledBuffer<BlockID> stored{ ChunkConstants::volume };
+        centre->decode(stored);
+
+        for (int y{ 0 }; y < size; ++y)
+        {
+            for (int z{ 0 }; z < size; ++z)
+            {
+                BlockID* row{ &m_blocks[index(0, y, z)] };
+                const BlockID* source{ &stored[ChunkLayout::index(0, y, z)] };
+
+                // Linear rows are contiguous and copy whole, Morton rows gather through the x spread table
+                if constexpr (std::is_same_v<ChunkLayout, VoxelLayout::Linear>)
+                {
+                    std::copy_n(source, size, row);
+                }
+                else
+                {
+                    for (int x{ 0 }; x < size; ++x)
+                        row[x] = source[VoxelLayout::Morton::spreadTable[x]];
+                }
+            }
+        }
+    }
+
+    // Apron: one face, edge or corner layer from each of the 26 neighbours
+    for (int dy{ -1 }; dy <= 1; ++dy)
+    {
+        for (int dz{ -1 }; dz <= 1; ++dz)
+        {
+            for (int dx{ -1 }; dx <= 1; ++dx)
+            {
+                if (dx == 0 && dy == 0 && dz == 0)
+                    continue;
+
+                const PaletteStorage* neighbour{ sources[sourceIndex(dx, dy, dz)] };
+                const bool uniform{ !neighbour || neighbour->isUniform() };
+                const BlockID fill{ neighbour ? neighbour->getUniformBlock() : outside };
+
+                const AxisRange xs{ apronRange(dx) };
+                const AxisRange ys{ apronRange(dy) };
+                const AxisRange zs{ apronRange(dz) };
+                for (int y{ ys.from }; y <= ys.to; ++y)
+                    for (int z{ zs.from }; z <= zs.to; ++z)
+                        for (int x{ xs.from }; x <= xs.to; ++x)
+                            m_blocks[index(x + dx * size, y + dy * size, z + dz * size)] = uniform ? fill : neighbour->get(ChunkLayout::index(x, y, z));
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CHUNK_SNAPSHOT_H
+#define CHUNK_SNAPSHOT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Block.h"
+#include "ChunkOccupancy.h"
+#include "ChunkPool.h"
+#include "Coordinates.h"
+
+class EpochGuard;
+class PaletteStorage;
+class World;
+
+namespace SnapshotConstants
+{
+    // One voxel of apron on every side
+    inline constexpr int padded{ ChunkConstants::size + 2 };
+    inline constexpr int paddedArea{ padded * padded };
+    inline constexpr int paddedVolume{ padded * padded * padded };
+
+    // The chunk itself and its 26 neighbours
+    inline constexpr int sourceCount{ 27 };
+}
+
+/*
+    Self-contained copy of a chunk plus a 1-voxel apron taken from its 26 neighbours.
+
+    Meshing and lighting jobs read everything they need from one contiguous buffer, with no
+    world lookups, hash probes or locks in the inner loop, and the snapshot can be moved to
+    a worker thread while the main thread keeps editing the world.
+*/
+class ChunkSnapshot
+{
+public:
+    // Main thread, copies the chunk and its apron, missing neighbours read as outside
+    ChunkSnapshot(const World& world, ChunkCoord coord, BlockID outside = Blocks::air);
+
+    // Worker threads, copies the published versions; unpublished chunks read as outside like missing ones
+    ChunkSnapshot(const World& world, ChunkCoord coord, const EpochGuard& guard, BlockID outside = Blocks::air);
+
+    ~ChunkSnapshot() = default;
+
+    // Move only, the buffer is 77 KiB and the bitmaps another 4 KiB
+    ChunkSnapshot(const ChunkSnapshot&) = delete;
+    ChunkSnapshot& operator=(const ChunkSnapshot&) = delete;
+    ChunkSnapshot(ChunkSnapshot&&) = default;
+    ChunkSnapshot& operator=(ChunkSnapshot&&) = default;
+
+    // Local coordinates, each component in [-1, ChunkConstants::size]
+    static constexpr int index(int x, int y, int z)
+    {
+        return ((y + 1) * SnapshotConstants::padded + (z + 1)) * SnapshotConstants::padded + (x + 1);
+    }
+
+    BlockID get(int x, int y, int z) const;
+
+    // Raw padded buffer indexed by index(), for hot loops
+    const BlockID* data() const;
+
+    ChunkCoord getCoord() const;
+
+    // The chunk itself was all air, or missing with an air outside; neighbours may still hold blocks
+    bool isEmpty() const;
+
+    // Occupancy of the chunk itself at copy time, taken from the chunk rather than rebuilt; a missing chunk is uniform like outside
+    const ChunkOccupancy& getOccupancy() const;
+
+    // Version of the chunk itself at copy time, 0 when it was missing
+    std::uint64_t getVersion() const;
+
+private:
+    // Indexed by (dy + 1) * 9 + (dz + 1) * 3 + (dx + 1), null for missing chunks
+    using Sources = std::array<const PaletteStorage*, SnapshotConstants::sourceCount>;
+
+    void copyFrom(const Sources& sources, BlockID outside);
+
+    ChunkCoord m_coord{};
+    bool m_isEmpty{ true };
+    std::uint64_t m_version{ 0 };
+    ChunkOccupancy m_occupancy{};
+    PooledBuffer<BlockID> m_blocks{};
+};
+
+#endif // !CHUNK_SNAPSHOT_H
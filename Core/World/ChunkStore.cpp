@@ -0,0 +1,165 @@
+#include "ChunkStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ChunkFormat.h"
+
+// === Helper Functions === //
+namespace
+{
+    // Each file is closed again once its table is read, regionFor reopens the ones in use
+    template <typename Fn>
+    void indexRegions(const std::filesystem::path& directory, Fn&& fn)
+    {
+        std::error_code error{};
+        for (const auto& entry : std::filesystem::directory_iterator{ directory, error })
+        {
+            const std::optional<ChunkCoord> region{ RegionFile::parseName(entry.path()) };
+            if (!region)
+                continue;
+
+            const RegionFile file{ entry.path(), *region };
+            if (file.isOpen())
+                file.forEachChunk(fn);
+        }
+    }
+
+    // Heightmap regions hold one slot per column, at chunk y 0
+    ChunkCoord heightmapSlot(ColumnCoord coord)
+    {
+        return ChunkCoord{ coord.x, 0, coord.z };
+    }
+}
+
+// === ChunkStore Class === //
+ChunkStore::ChunkStore(std::filesystem::path directory)
+    : m_directory{ std::move(directory) }
+    , m_heightmapDirectory{ m_directory / "heightmaps" }
+{
+    std::error_code error{};
+    std::filesystem::create_directories(m_heightmapDirectory, error);
+    if (error)
+    {
+        std::cout << "Failed to create chunk directory: " << m_heightmapDirectory.string() << '\n';
+        return;
+    }
+
+    indexRegions(m_directory, [&](ChunkCoord coord) { m_stored.insert(coord); });
+    indexRegions(m_heightmapDirectory, [&](ChunkCoord coord) { m_storedHeightmaps.insert({ coord.x, coord.z }); });
+}
+
+bool ChunkStore::contains(ChunkCoord coord) const
+{
+    return m_stored.contains(coord);
+}
+
+bool ChunkStore::load(Chunk& chunk) const
+{
+    // Checked first, opening the region of a chunk never saved would create an empty file
+    const ChunkCoord coord{ chunk.getCoord() };
+    if (!m_stored.contains(coord))
+        return false;
+
+    RegionFile* region{ regionFor(m_regions, m_directory, coord) };
+    if (!region || !region->contains(coord))
+        return false;
+
+    // Reused per thread so a steady stream of loads stops allocating, heap buffers are aligned well past the 8 bytes a view needs
+    thread_local std::vector<std::byte> payload{};
+    if (!region->read(coord, payload))
+        return false;
+
+    const std::optional<ChunkView> view{ ChunkView::open(payload) };
+    if (!view || view->getCoord() != coord)
+    {
+        std::cout << "Corrupt chunk " << coord.x << ' ' << coord.y << ' ' << coord.z << " in region file\n";
+        return false;
+    }
+
+    if (!ChunkFormat::load(*view, chunk))
+        return false;
+
+    chunk.markSaved();
+    return true;
+}
+
+bool ChunkStore::save(const Chunk& chunk)
+{
+    const ChunkCoord coord{ chunk.getCoord() };
+    RegionFile* region{ regionFor(m_regions, m_directory, coord) };
+    if (!region || !region->write(coord, ChunkFormat::serialize(chunk)))
+        return false;
+
+    m_stored.insert(coord);
+    return true;
+}
+
+bool ChunkStore::containsHeightmap(ColumnCoord coord) const
+{
+    return m_storedHeightmaps.contains(coord);
+}
+
+std::optional<ColumnHeightmap> ChunkStore::loadHeightmap(ColumnCoord coord) const
+{
+    if (!m_storedHeightmaps.contains(coord))
+        return std::nullopt;
+
+    RegionFile* region{ regionFor(m_heightmapRegions, m_heightmapDirectory, heightmapSlot(coord)) };
+    std::vector<std::byte> payload{};
+    if (!region || !region->read(heightmapSlot(coord), payload))
+        return std::nullopt;
+
+    if (payload.size() != sizeof(HeightmapData))
+    {
+        std::cout << "Corrupt heightmap " << coord.x << ' ' << coord.z << " in region file\n";
+        return std::nullopt;
+    }
+
+    HeightmapData data{};
+    std::memcpy(&data, payload.data(), sizeof(data));
+    return ColumnHeightmap{ data };
+}
+
+bool ChunkStore::saveHeightmap(ColumnCoord coord, const ColumnHeightmap& heightmap)
+{
+    static_assert(std::is_trivially_copyable_v<HeightmapData>, "Heightmaps are written as raw bytes");
+
+    RegionFile* region{ regionFor(m_heightmapRegions, m_heightmapDirectory, heightmapSlot(coord)) };
+    const auto bytes{ std::as_bytes(std::span{ &heightmap.getData(), 1 }) };
+    if (!region || !region->write(heightmapSlot(coord), bytes))
+        return false;
+
+    m_storedHeightmaps.insert(coord);
+    return true;
+}
+
+RegionFile* ChunkStore::regionFor(RegionCache& regions, const std::filesystem::path& directory, ChunkCoord coord)
+{
+    const ChunkCoord key{ RegionFile::regionOf(coord) };
+    auto it{ std::find_if(regions.begin(), regions.end(), [&](const auto& file) { return file->getRegion() == key; }) };
+    if (it != regions.end())
+    {
+        std::rotate(regions.begin(), it, it + 1);
+        return regions.front().get();
+    }
+
+    auto file{ std::make_unique<RegionFile>(directory / RegionFile::nameFor(key), key) };
+    if (!file->isOpen())
+        return nullptr;
+
+    // Closing the least recently used file is enough, every write has already reached it
+    if (regions.size() >= ChunkStoreConstants::openRegions)
+        regions.pop_back();
+
+    regions.insert(regions.begin(), std::move(file));
+    return regions.front().get();
+}
@@ -0,0 +1,77 @@
+#ifndef CHUNK_STORE_H
+#define CHUNK_STORE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "Chunk.h"
+#include "Coordinates.h"
+#include "Heightmap.h"
+#include "RegionFile.h"
+
+namespace ChunkStoreConstants
+{
+    // Region files kept open at once, the least recently used one is closed past this
+    inline constexpr std::size_t openRegions{ 16 };
+}
+
+/*
+    On-disk home for chunks evicted from memory, grouped into one RegionFile per region.
+
+    Each chunk is stored in ChunkFormat, so loading copies its sections straight into storage.
+    Only the most recently used regions stay open, so file handles and sector maps stay bounded
+    however far the player travels.
+
+    Heightmaps of columns with nothing resident go to region files of their own in a
+    "heightmaps" subdirectory, one slot per chunk column at y 0.
+*/
+class ChunkStore
+{
+public:
+    // No default constructor, a store always has a directory
+    ChunkStore() = delete;
+
+    // Creates the directories when missing and indexes the region files already in them, reading only their tables
+    explicit ChunkStore(std::filesystem::path directory);
+
+    ~ChunkStore() = default;
+
+    // Deleted copy and move operations, two stores over one directory would fight over its files
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+    ChunkStore(ChunkStore&&) = delete;
+    ChunkStore& operator=(ChunkStore&&) = delete;
+
+    // Answered from the in-memory index, no file system access
+    bool contains(ChunkCoord coord) const;
+
+    // Both return false on failure, a chunk that fails to load is left untouched
+    bool load(Chunk& chunk) const;
+    bool save(const Chunk& chunk);
+
+    // Column heightmaps, the load comes back as saved and is nullopt when missing or unreadable
+    bool containsHeightmap(ColumnCoord coord) const;
+    std::optional<ColumnHeightmap> loadHeightmap(ColumnCoord coord) const;
+    bool saveHeightmap(ColumnCoord coord, const ColumnHeightmap& heightmap);
+
+private:
+    using RegionCache = std::vector<std::unique_ptr<RegionFile>>;
+
+    // Opened on first use and moved to the front, nullptr when the file can't be opened or created
+    static RegionFile* regionFor(RegionCache& regions, const std::filesystem::path& directory, ChunkCoord coord);
+
+    std::filesystem::path m_directory{};
+    std::filesystem::path m_heightmapDirectory{};
+    std::unordered_set<ChunkCoord, ChunkCoordHash> m_stored{};
+    std::unordered_set<ColumnCoord, ColumnCoordHash> m_storedHeightmaps{};
+
+    // Most recently used first, at most openRegions long each. Reads move the file position so loads need them mutable
+    mutable RegionCache m_regions{};
+    mutable RegionCache m_heightmapRegions{};
+};
+
+#endif // !CHUNK_STORE_H
@@ -0,0 +1,88 @@
+#include "ConcurrentChunkMap.h"
+
+#include <cstdint>
+
+ChunkHandle ConcurrentChunkMap::find(ChunkCoord coord) const
+{
+    const Shard& shard{ shardFor(coord) };
+    std::shared_lock lock{ shard.mutex };
+
+    auto it{ shard.chunks.find(coord) };
+    return it != shard.chunks.end() ? it->second : nullptr;
+}
+
+ChunkHandle ConcurrentChunkMap::findOrCreate(ChunkCoord coord)
+{
+    Shard& shard{ shardFor(coord) };
+
+    // Most calls hit an existing chunk, try under the shared lock first
+    {
+        std::shared_lock lock{ shard.mutex };
+        auto it{ shard.chunks.find(coord) };
+        if (it != shard.chunks.end())
+            return it->second;
+    }
+
+    std::unique_lock lock{ shard.mutex };
+    ChunkHandle& slot{ shard.chunks[coord] };
+    if (!slot)
+    {
+        slot = makePooled<Chunk>(coord);
+        ++m_size;
+    }
+
+    return slot;
+}
+
+void ConcurrentChunkMap::insert(ChunkCoord coord, ChunkHandle chunk)
+{
+    Shard& shard{ shardFor(coord) };
+    std::unique_lock lock{ shard.mutex };
+
+    auto [it, inserted]{ shard.chunks.insert_or_assign(coord, std::move(chunk)) };
+    if (inserted)
+        ++m_size;
+}
+
+ChunkHandle ConcurrentChunkMap::erase(ChunkCoord coord)
+{
+    Shard& shard{ shardFor(coord) };
+    std::unique_lock lock{ shard.mutex };
+
+    auto it{ shard.chunks.find(coord) };
+    if (it == shard.chunks.end())
+        return nullptr;
+
+    ChunkHandle evicted{ std::move(it->second) };
+    shard.chunks.erase(it);
+    --m_size;
+    return evicted;
+}
+
+void ConcurrentChunkMap::clear()
+{
+    for (Shard& shard : m_shards)
+    {
+        std::unique_lock lock{ shard.mutex };
+        m_size -= shard.chunks.size();
+        shard.chunks.clear();
+    }
+}
+
+std::size_t ConcurrentChunkMap::size() const
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+ConcurrentChunkMap::Shard& ConcurrentChunkMap::shardFor(ChunkCoord coord)
+{
+    // Fibonacci hashing takes the top bits, the map itself uses the low bits for buckets
+    const std::uint64_t hash{ static_cast<std::uint64_t>(ChunkCoordHash{}(coord)) * 0x9E3779B97F4A7C15ull };
+    return m_shards[hash >> (64 - ChunkMapConstants::shardCountLog2)];
+}
+
+const ConcurrentChunkMap::Shard& ConcurrentChunkMap::shardFor(ChunkCoord coord) const
+{
+    const std::uint64_t hash{ static_cast<std::uint64_t>(ChunkCoordHash{}(coord)) * 0x9E3779B97F4A7C15ull };
+    return m_shards[hash >> (64 - ChunkMapConstants::shardCountLog2)];
+}
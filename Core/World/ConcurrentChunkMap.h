@@ -0,0 +1,97 @@
+#ifndef CONCURRENT_CHUNK_MAP_H
+#define CONCURRENT_CHUNK_MAP_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "Chunk.h"
+#include "ChunkPool.h"
+#include "Coordinates.h"
+
+// Reference-counted chunk, a worker holding one keeps the chunk alive after it is evicted
+using ChunkHandle = std::shared_ptr<Chunk>;
+
+namespace ChunkMapConstants
+{
+    // Power of two, enough that 32 threads rarely meet on the same shard
+    inline constexpr int shardCountLog2{ 6 };
+    inline constexpr int shardCount{ 1 << shardCountLog2 };
+}
+
+/*
+    Chunk map shared between the main thread and workers.
+
+    Chunks are spread over independently locked shards, so readers only take a shared lock
+    on one shard for the duration of a lookup and never block each other. Inserts and evictions
+    lock a single shard exclusively. Handles outlive eviction, so a worker can finish with a
+    chunk the main thread has already dropped.
+*/
+class ConcurrentChunkMap
+{
+public:
+    ConcurrentChunkMap() = default;
+    ~ConcurrentChunkMap() = default;
+
+    // Deleted copy and move operations, shards hold mutexes
+    ConcurrentChunkMap(const ConcurrentChunkMap&) = delete;
+    ConcurrentChunkMap& operator=(const ConcurrentChunkMap&) = delete;
+    ConcurrentChunkMap(ConcurrentChunkMap&&) = delete;
+    ConcurrentChunkMap& operator=(ConcurrentChunkMap&&) = delete;
+
+    // Returns an empty handle when the chunk is not loaded
+    ChunkHandle find(ChunkCoord coord) const;
+
+    // Creates an empty chunk when none exists yet
+    ChunkHandle findOrCreate(ChunkCoord coord);
+
+    // Replaces any chunk already stored at coord
+    void insert(ChunkCoord coord, ChunkHandle chunk);
+
+    // Returns the evicted chunk, or an empty handle when nothing was stored
+    ChunkHandle erase(ChunkCoord coord);
+
+    void clear();
+    std::size_t size() const;
+
+    /*
+        Calls fn(const ChunkCoord&, const ChunkHandle&) for every chunk, one shard at a time
+        under its shared lock. fn must not insert into or erase from this map.
+    */
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+private:
+    // Padded to a cache line so neighbouring shard locks don't false-share
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex{};
+        // Nodes come from the pool, streaming a chunk in and out doesn't touch the system allocator
+        std::unordered_map<ChunkCoord, ChunkHandle, ChunkCoordHash, std::equal_to<ChunkCoord>,
+            PoolAllocator<std::pair<const ChunkCoord, ChunkHandle>>> chunks{};
+    };
+
+    Shard& shardFor(ChunkCoord coord);
+    const Shard& shardFor(ChunkCoord coord) const;
+
+    std::array<Shard, ChunkMapConstants::shardCount> m_shards{};
+    std::atomic<std::size_t> m_size{ 0 };
+};
+
+template <typename Fn>
+void ConcurrentChunkMap::forEach(Fn&& fn) const
+{
+    for (const Shard& shard : m_shards)
+    {
+        std::shared_lock lock{ shard.mutex };
+        for (const auto& [coord, chunk] : shard.chunks)
+            fn(coord, chunk);
+    }
+}
+
+#endif // !CONCURRENT_CHUNK_MAP_H
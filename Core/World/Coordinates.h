@@ -0,0 +1,159 @@
+#ifndef COORDINATES_H
+#define COORDINATES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Integer type used for world-space block coordinates, 64-bit so worlds never run out of range
+using BlockCoord = std::int64_t;
+
+namespace ChunkConstants
+{
+    // Chunk edge length must stay a power of two, coordinate helpers rely on shifts and masks
+    inline constexpr int sizeLog2{ 5 };
+    inline constexpr int size{ 1 << sizeLog2 };
+    inline constexpr int mask{ size - 1 };
+    inline constexpr int area{ size * size };
+    inline constexpr int volume{ size * size * size };
+}
+
+namespace Coordinates
+{
+    // Final avalanche of a coordinate hash, far-apart chunks differ in their high bits only
+    inline constexpr std::size_t mixHash(std::uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDu;
+        hash ^= hash >> 33;
+        return static_cast<std::size_t>(hash);
+    }
+}
+
+// Position of a chunk in chunk units (world position / chunk size)
+struct ChunkCoord
+{
+    BlockCoord x{};
+    BlockCoord y{};
+    BlockCoord z{};
+
+    friend bool operator==(const ChunkCoord&, const ChunkCoord&) = default;
+};
+
+struct ChunkCoordHash
+{
+    std::size_t operator()(const ChunkCoord& coord) const noexcept
+    {
+        return Coordinates::mixHash(
+            static_cast<std::uint64_t>(coord.x) * 0x9E3779B97F4A7C15u
+            ^ static_cast<std::uint64_t>(coord.y) * 0xC2B2AE3D27D4EB4Fu
+            ^ static_cast<std::uint64_t>(coord.z) * 0x165667B19E3779F9u);
+    }
+};
+
+// Vertical stack of chunks, the x and z of its ChunkCoords
+struct ColumnCoord
+{
+    BlockCoord x{};
+    BlockCoord z{};
+
+    friend bool operator==(const ColumnCoord&, const ColumnCoord&) = default;
+};
+
+struct ColumnCoordHash
+{
+    std::size_t operator()(const ColumnCoord& coord) const noexcept
+    {
+        return Coordinates::mixHash(
+            static_cast<std::uint64_t>(coord.x) * 0x9E3779B97F4A7C15u
+            ^ static_cast<std::uint64_t>(coord.z) * 0x165667B19E3779F9u);
+    }
+};
+
+// Position of a block inside its chunk, each component is in [0, ChunkConstants::size)
+struct LocalPos
+{
+    int x{};
+    int y{};
+    int z{};
+};
+
+// Part of one chunk, local coordinates with both corners inclusive
+struct LocalBox
+{
+    LocalPos min{};
+    LocalPos max{};
+};
+
+// Position of a block in world coordinates
+struct WorldPos
+{
+    BlockCoord x{};
+    BlockCoord y{};
+    BlockCoord z{};
+
+    friend bool operator==(const WorldPos&, const WorldPos&) = default;
+};
+
+// Axis-aligned box of blocks, both corners inclusive
+struct BlockBox
+{
+    WorldPos min{};
+    WorldPos max{};
+};
+
+// Face order shared by neighbourhood iterators and meshers
+namespace Faces
+{
+    enum Face
+    {
+        posX,
+        negX,
+        posY,
+        negY,
+        posZ,
+        negZ,
+        count,
+    };
+
+    inline constexpr LocalPos offsets[count]{
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+}
+
+namespace Coordinates
+{
+    // Arithmetic shift floors negative coordinates, so -1 lands in chunk -1 instead of 0
+    inline constexpr BlockCoord worldToChunk(BlockCoord world)
+    {
+        return world >> ChunkConstants::sizeLog2;
+    }
+
+    inline constexpr int worldToLocal(BlockCoord world)
+    {
+        return static_cast<int>(world & ChunkConstants::mask);
+    }
+
+    inline constexpr BlockCoord chunkToWorld(BlockCoord chunk, int local = 0)
+    {
+        return chunk * ChunkConstants::size + local;
+    }
+
+    inline constexpr ChunkCoord worldToChunk(BlockCoord x, BlockCoord y, BlockCoord z)
+    {
+        return ChunkCoord{ worldToChunk(x), worldToChunk(y), worldToChunk(z) };
+    }
+
+    inline constexpr LocalPos worldToLocal(BlockCoord x, BlockCoord y, BlockCoord z)
+    {
+        return LocalPos{ worldToLocal(x), worldToLocal(y), worldToLocal(z) };
+    }
+
+    // Flat index of a local position, x varies fastest then z then y
+    inline constexpr int localToIndex(int x, int y, int z)
+    {
+        return (y * ChunkConstants::size + z) * ChunkConstants::size + x;
+    }
+}
+
+#endif // !COORDINATES_H
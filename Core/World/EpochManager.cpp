@@ -0,0 +1,108 @@
+#include "EpochManager.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+// === EpochManager Class === //
+EpochManager& EpochManager::instance()
+{
+    // Never destroyed, chunks owned by other statics still retire their versions during shutdown
+    static EpochManager* manager{ new EpochManager{} };
+    return *manager;
+}
+
+void EpochManager::retire(std::shared_ptr<const void> object)
+{
+    if (!object)
+        return;
+
+    // The epoch is read after the caller unpublished object, a reader pinned later can't reach it
+    const std::uint64_t epoch{ m_epoch.load() };
+
+    std::lock_guard lock{ m_mutex };
+    m_retired.push_back({ epoch, std::move(object) });
+}
+
+void EpochManager::advance()
+{
+    m_epoch.fetch_add(1);
+
+    // Destroyed outside the lock, freeing storage takes the chunk pool's own lock
+    std::vector<Retired> freed{};
+    {
+        std::lock_guard lock{ m_mutex };
+        const std::uint64_t oldest{ getOldestPinned() };
+
+        auto firstFreed{ std::partition(m_retired.begin(), m_retired.end(), [oldest](const Retired& retired) {
+            return retired.epoch >= oldest;
+        }) };
+
+        freed.assign(std::make_move_iterator(firstFreed), std::make_move_iterator(m_retired.end()));
+        m_retired.erase(firstFreed, m_retired.end());
+    }
+}
+
+std::uint64_t EpochManager::getEpoch() const
+{
+    return m_epoch.load();
+}
+
+std::size_t EpochManager::getRetiredCount() const
+{
+    std::lock_guard lock{ m_mutex };
+    return m_retired.size();
+}
+
+int EpochManager::pin()
+{
+    // Each thread starts at the slot it used last, so threads rarely contend for one
+    thread_local int hint{ 0 };
+
+    while (true)
+    {
+        const std::uint64_t epoch{ m_epoch.load() };
+        for (int i{ 0 }; i < EpochConstants::maxReaders; ++i)
+        {
+            const int slot{ (hint + i) % EpochConstants::maxReaders };
+            std::uint64_t expected{ 0 };
+            if (m_slots[slot].epoch.compare_exchange_strong(expected, epoch))
+            {
+                hint = slot;
+                return slot;
+            }
+        }
+
+        // Every slot is pinned, wait for a reader to finish
+        std::this_thread::yield();
+    }
+}
+
+void EpochManager::unpin(int slot)
+{
+    m_slots[slot].epoch.store(0);
+}
+
+std::uint64_t EpochManager::getOldestPinned() const
+{
+    std::uint64_t oldest{ m_epoch.load() + 1 };
+    for (const ReaderSlot& slot : m_slots)
+    {
+        const std::uint64_t epoch{ slot.epoch.load() };
+        if (epoch != 0)
+            oldest = std::min(oldest, epoch);
+    }
+
+    return oldest;
+}
+
+// === EpochGuard Class === //
+EpochGuard::EpochGuard()
+    : m_slot{ EpochManager::instance().pin() }
+{
+}
+
+EpochGuard::~EpochGuard()
+{
+    EpochManager::instance().unpin(m_slot);
+}
@@ -0,0 +1,96 @@
+#ifndef EPOCH_MANAGER_H
+#define EPOCH_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace EpochConstants
+{
+    // Guards that can be pinned at once across all threads, well above any worker count
+    inline constexpr int maxReaders{ 64 };
+}
+
+/*
+    Epoch-based reclamation for data shared with worker threads.
+
+    Readers pin the current epoch with an EpochGuard before loading a published pointer, and
+    writers hand replaced objects to retire() instead of freeing them. advance() starts a new
+    epoch and frees everything retired before the oldest epoch still pinned, so a reader never
+    blocks a writer and never sees an object freed underneath it.
+*/
+class EpochManager
+{
+public:
+    static EpochManager& instance();
+
+    ~EpochManager() = default;
+
+    // Deleted copy and move operations, there is one manager per process
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+    EpochManager(EpochManager&&) = delete;
+    EpochManager& operator=(EpochManager&&) = delete;
+
+    // Keeps object alive until no reader pinned in the current epoch or earlier is left
+    void retire(std::shared_ptr<const void> object);
+
+    // Starts a new epoch and frees what no reader can still see, the main thread calls it once per frame
+    void advance();
+
+    std::uint64_t getEpoch() const;
+    std::size_t getRetiredCount() const;
+
+private:
+    friend class EpochGuard;
+
+    // Padded to a cache line, every pin and unpin writes its slot
+    struct alignas(64) ReaderSlot
+    {
+        // 0 while the slot is free
+        std::atomic<std::uint64_t> epoch{ 0 };
+    };
+
+    struct Retired
+    {
+        std::uint64_t epoch{};
+        std::shared_ptr<const void> object{};
+    };
+
+    EpochManager() = default;
+
+    int pin();
+    void unpin(int slot);
+
+    // Oldest epoch still pinned, one past the current epoch when nothing is pinned
+    std::uint64_t getOldestPinned() const;
+
+    std::atomic<std::uint64_t> m_epoch{ 1 };
+    std::array<ReaderSlot, EpochConstants::maxReaders> m_slots{};
+
+    mutable std::mutex m_mutex{};
+    std::vector<Retired> m_retired{};
+};
+
+// Pins the current epoch for its lifetime, published data loaded meanwhile stays valid
+class EpochGuard
+{
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    // Deleted copy and move operations, a guard is tied to the scope that pinned it
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+    EpochGuard(EpochGuard&&) = delete;
+    EpochGuard& operator=(EpochGuard&&) = delete;
+
+private:
+    int m_slot{};
+};
+
+#endif // !EPOCH_MANAGER_H
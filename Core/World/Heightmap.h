@@ -0,0 +1,130 @@
+#ifndef HEIGHTMAP_H
+#define HEIGHTMAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "Block.h"
+#include "BlockRegistry.h"
+#include "Coordinates.h"
+
+namespace Heightmaps
+{
+    // Which blocks a heightmap tracks, surface is any registered block but air
+    enum Type
+    {
+        surface,
+        solid,
+        opaque,
+        fluid,
+        count,
+    };
+
+    // Height of a column that holds no block of the kind
+    inline constexpr BlockCoord none{ std::numeric_limits<BlockCoord>::min() };
+
+    // Stored form of none, heights are kept as 32-bit offsets from the column's base y
+    inline constexpr std::int32_t noneOffset{ std::numeric_limits<std::int32_t>::min() };
+
+    inline constexpr bool matches(Type type, BlockID block)
+    {
+        switch (type)
+        {
+        case solid:
+            return BlockRegistry::isSolid(block);
+        case opaque:
+            return BlockRegistry::isOpaque(block);
+        case fluid:
+            return BlockRegistry::isFluid(block);
+        default:
+            return BlockRegistry::isKnown(block) && block != Blocks::air;
+        }
+    }
+}
+
+// Plain data of one heightmap, the chunk store writes it as is
+struct HeightmapData
+{
+    BlockCoord base{};
+    BlockCoord bottomChunk{ std::numeric_limits<BlockCoord>::max() };
+    std::array<std::array<std::int32_t, ChunkConstants::area>, Heightmaps::count> heights{};
+};
+
+/*
+    World y of the highest block of each kind in every x, z column of one chunk column.
+
+    The world keeps these up to date as blocks are written, so reading a height is a single
+    array load. Columns are indexed by local x and z like the chunks above them. Heights are
+    stored as 32-bit offsets from the base y the column was created with, 16 KiB per column,
+    and saturate more than two billion blocks away from it.
+*/
+class ColumnHeightmap
+{
+public:
+    // Constructor, every column starts without blocks
+    explicit ColumnHeightmap(BlockCoord base)
+    {
+        m_data.base = base;
+        for (auto& heights : m_data.heights)
+            heights.fill(Heightmaps::noneOffset);
+    }
+
+    // Constructor, from data the chunk store read back, counts as saved
+    explicit ColumnHeightmap(const HeightmapData& data)
+        : m_data{ data }
+        , m_modified{ false }
+    {
+    }
+
+    BlockCoord get(Heightmaps::Type type, int x, int z) const
+    {
+        const std::int32_t offset{ m_data.heights[type][z * ChunkConstants::size + x] };
+        return offset == Heightmaps::noneOffset ? Heightmaps::none : m_data.base + offset;
+    }
+
+    void set(Heightmaps::Type type, int x, int z, BlockCoord height)
+    {
+        constexpr BlockCoord lowest{ static_cast<BlockCoord>(Heightmaps::noneOffset) + 1 };
+        constexpr BlockCoord highest{ std::numeric_limits<std::int32_t>::max() };
+
+        const std::int32_t offset{ height == Heightmaps::none ? Heightmaps::noneOffset
+            : static_cast<std::int32_t>(std::clamp(height - m_data.base, lowest, highest)) };
+        std::int32_t& stored{ m_data.heights[type][z * ChunkConstants::size + x] };
+        m_modified |= stored != offset;
+        stored = offset;
+    }
+
+    // Lowest chunk y that ever held a block, searches for the next height down stop there
+    BlockCoord getBottomChunk() const
+    {
+        return m_data.bottomChunk;
+    }
+
+    void extendDown(BlockCoord chunkY)
+    {
+        if (chunkY < m_data.bottomChunk)
+        {
+            m_data.bottomChunk = chunkY;
+            m_modified = true;
+        }
+    }
+
+    const HeightmapData& getData() const
+    {
+        return m_data;
+    }
+
+    // Changed since it was created or read back from the chunk store
+    bool isModifiedSinceSave() const
+    {
+        return m_modified;
+    }
+
+private:
+    HeightmapData m_data{};
+    bool m_modified{ true };
+};
+
+#endif // !HEIGHTMAP_H
@@ -0,0 +1,229 @@
+#include "OctreeWorld.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+OctreeWorld::OctreeWorld()
+    : m_nodes(8)
+{
+}
+
+BlockID OctreeWorld::getBlock(BlockCoord x, BlockCoord y, BlockCoord z) const
+{
+    if (!isInside(x, y, z))
+        return Blocks::air;
+
+    const glm::ivec3 treePos{ glm::ivec3{ x, y, z } + glm::ivec3{ OctreeConstants::halfExtent } };
+    return lookup(treePos).node->block;
+}
+
+void OctreeWorld::setBlock(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block)
+{
+    if (!isInside(x, y, z))
+        return;
+
+    const glm::ivec3 treePos{ glm::ivec3{ x, y, z } + glm::ivec3{ OctreeConstants::halfExtent } };
+
+    // Walk down, splitting leaves that don't already hold the block
+    std::array<std::uint32_t, OctreeConstants::rootLog2> path{};
+    int depth{ 0 };
+    std::uint32_t nodeIndex{ 0 };
+
+    for (int sizeLog2{ OctreeConstants::rootLog2 }; sizeLog2 > 0; --sizeLog2)
+    {
+        if (m_nodes[nodeIndex].children == 0)
+        {
+            if (m_nodes[nodeIndex].block == block)
+                return;
+
+            // allocateBrick may grow m_nodes, so no references are held across it
+            const std::uint32_t brick{ allocateBrick(m_nodes[nodeIndex].block) };
+            m_nodes[nodeIndex].children = brick;
+        }
+
+        path[depth++] = nodeIndex;
+        nodeIndex = m_nodes[nodeIndex].children + childSlot(treePos, sizeLog2 - 1);
+    }
+
+    m_nodes[nodeIndex].block = block;
+
+    // Walk back up, collapsing every brick that became homogeneous
+    while (depth > 0)
+    {
+        const std::uint32_t parent{ path[--depth] };
+        const std::uint32_t brick{ m_nodes[parent].children };
+
+        for (std::uint32_t slot{ 0 }; slot < 8; ++slot)
+        {
+            const Node& child{ m_nodes[brick + slot] };
+            if (child.children != 0 || child.block != block)
+                return;
+        }
+
+        freeBrick(brick);
+        m_nodes[parent].children = 0;
+        m_nodes[parent].block = block;
+    }
+}
+
+std::optional<RaycastHit> OctreeWorld::raycast(const glm::dvec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+    const float length{ glm::length(direction) };
+    if (length == 0.0f)
+        return std::nullopt;
+
+    // Tree space coordinates reach 2^20, doubles keep sub-voxel precision out there
+    const glm::dvec3 rayOrigin{ origin + glm::dvec3{ static_cast<double>(OctreeConstants::halfExtent) } };
+    const glm::dvec3 rayDir{ glm::dvec3{ direction } / static_cast<double>(length) };
+    constexpr int treeSize{ 1 << OctreeConstants::rootLog2 };
+
+    glm::ivec3 normal{ 0 };
+    double distance{ 0.0 };
+
+    // Rays from outside the tree start where they enter it, a far origin doesn't fit an int cell
+    int entryAxis{ -1 };
+    double leaveDistance{ std::numeric_limits<double>::infinity() };
+    for (int axis{ 0 }; axis < 3; ++axis)
+    {
+        if (rayDir[axis] == 0.0)
+        {
+            if (rayOrigin[axis] < 0.0 || rayOrigin[axis] >= treeSize)
+                return std::nullopt;
+            continue;
+        }
+
+        const double enter{ ((rayDir[axis] > 0.0 ? 0.0 : treeSize) - rayOrigin[axis]) / rayDir[axis] };
+        const double leave{ ((rayDir[axis] > 0.0 ? treeSize : 0.0) - rayOrigin[axis]) / rayDir[axis] };
+        if (enter > distance)
+        {
+            distance = enter;
+            entryAxis = axis;
+        }
+        leaveDistance = std::min(leaveDistance, leave);
+    }
+
+    if (distance >= leaveDistance || distance > maxDistance)
+        return std::nullopt;
+
+    const glm::dvec3 entryPoint{ rayOrigin + rayDir * distance };
+    glm::ivec3 cell{ glm::clamp(glm::floor(entryPoint), glm::dvec3{ 0.0 }, glm::dvec3{ treeSize - 1.0 }) };
+    if (entryAxis >= 0)
+    {
+        cell[entryAxis] = rayDir[entryAxis] > 0.0 ? 0 : treeSize - 1;
+        normal[entryAxis] = rayDir[entryAxis] > 0.0 ? -1 : 1;
+    }
+
+    while (true)
+    {
+        if (glm::any(glm::lessThan(cell, glm::ivec3{ 0 })) || glm::any(glm::greaterThanEqual(cell, glm::ivec3{ treeSize })))
+            return std::nullopt;
+
+        const NodeLookup found{ lookup(cell) };
+        if (found.node->block != Blocks::air)
+        {
+            using OctreeConstants::halfExtent;
+            return RaycastHit{ cell.x - halfExtent, cell.y - halfExtent, cell.z - halfExtent, found.node->block, normal, static_cast<float>(distance) };
+        }
+
+        // Leave the whole empty node in one step instead of visiting its voxels
+        const int nodeSize{ 1 << found.sizeLog2 };
+        int exitAxis{ 0 };
+        double exitDistance{ std::numeric_limits<double>::infinity() };
+        for (int axis{ 0 }; axis < 3; ++axis)
+        {
+            if (rayDir[axis] == 0.0)
+                continue;
+
+            const int boundary{ rayDir[axis] > 0.0 ? found.min[axis] + nodeSize : found.min[axis] };
+            const double t{ (boundary - rayOrigin[axis]) / rayDir[axis] };
+            if (t < exitDistance)
+            {
+                exitDistance = t;
+                exitAxis = axis;
+            }
+        }
+
+        if (exitDistance > maxDistance)
+            return std::nullopt;
+
+        // Step into the neighbouring cell, clamping the other axes so rounding can't skip a node
+        const glm::dvec3 exitPoint{ rayOrigin + rayDir * exitDistance };
+        for (int axis{ 0 }; axis < 3; ++axis)
+        {
+            if (axis == exitAxis)
+                cell[axis] = rayDir[axis] > 0.0 ? found.min[axis] + nodeSize : found.min[axis] - 1;
+            else
+                cell[axis] = glm::clamp(static_cast<int>(std::floor(exitPoint[axis])), found.min[axis], found.min[axis] + nodeSize - 1);
+        }
+
+        normal = glm::ivec3{ 0 };
+        normal[exitAxis] = rayDir[exitAxis] > 0.0 ? -1 : 1;
+        distance = exitDistance;
+    }
+}
+
+std::size_t OctreeWorld::getNodeCount() const
+{
+    return m_nodes.size() - m_freeBricks.size() * 8;
+}
+
+std::size_t OctreeWorld::getMemoryUsage() const
+{
+    return m_nodes.capacity() * sizeof(Node) + m_freeBricks.capacity() * sizeof(std::uint32_t);
+}
+
+bool OctreeWorld::isInside(BlockCoord x, BlockCoord y, BlockCoord z)
+{
+    using OctreeConstants::halfExtent;
+    return x >= -halfExtent && x < halfExtent
+        && y >= -halfExtent && y < halfExtent
+        && z >= -halfExtent && z < halfExtent;
+}
+
+int OctreeWorld::childSlot(const glm::ivec3& treePos, int childLog2)
+{
+    return ((treePos.x >> childLog2) & 1)
+        | (((treePos.y >> childLog2) & 1) << 1)
+        | (((treePos.z >> childLog2) & 1) << 2);
+}
+
+OctreeWorld::NodeLookup OctreeWorld::lookup(const glm::ivec3& treePos) const
+{
+    NodeLookup result{ &m_nodes[0], OctreeConstants::rootLog2, glm::ivec3{ 0 } };
+    while (result.node->children != 0)
+    {
+        --result.sizeLog2;
+        const int slot{ childSlot(treePos, result.sizeLog2) };
+        result.min += glm::ivec3{ slot & 1, (slot >> 1) & 1, (slot >> 2) & 1 } * (1 << result.sizeLog2);
+        result.node = &m_nodes[result.node->children + slot];
+    }
+
+    return result;
+}
+
+std::uint32_t OctreeWorld::allocateBrick(BlockID fill)
+{
+    std::uint32_t brick{};
+    if (!m_freeBricks.empty())
+    {
+        brick = m_freeBricks.back();
+        m_freeBricks.pop_back();
+    }
+    else
+    {
+        brick = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + 8);
+    }
+
+    for (std::uint32_t slot{ 0 }; slot < 8; ++slot)
+        m_nodes[brick + slot] = Node{ 0, fill };
+
+    return brick;
+}
+
+void OctreeWorld::freeBrick(std::uint32_t brick)
+{
+    m_freeBricks.push_back(brick);
+}
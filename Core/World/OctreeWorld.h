@@ -0,0 +1,139 @@
+#ifndef OCTREE_WORLD_H
+#define OCTREE_WORLD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "Coordinates.h"
+#include "Raycast.h"
+
+namespace OctreeConstants
+{
+    // The tree covers [-2^(rootLog2 - 1), 2^(rootLog2 - 1)) on every axis
+    inline constexpr int rootLog2{ 20 };
+    inline constexpr BlockCoord halfExtent{ BlockCoord{ 1 } << (rootLog2 - 1) };
+}
+
+/*
+    Sparse voxel octree world backend for sky islands, space maps and other mostly empty worlds.
+
+    Any node whose eight children hold the same block collapses into a single leaf, so empty
+    space costs one node no matter how large it is. Children of a node live together in one
+    8-node brick (64 bytes, one cache line) and freed bricks are recycled.
+
+    Offers the same getBlock/setBlock interface as World, plus raycasts and region iteration
+    that step over whole empty nodes instead of individual voxels.
+*/
+class OctreeWorld
+{
+public:
+    OctreeWorld();
+    ~OctreeWorld() = default;
+
+    // Deleted copy and move operations, same as World
+    OctreeWorld(const OctreeWorld&) = delete;
+    OctreeWorld& operator=(const OctreeWorld&) = delete;
+    OctreeWorld(OctreeWorld&&) = delete;
+    OctreeWorld& operator=(OctreeWorld&&) = delete;
+
+    // Positions outside the tree read as air and ignore writes
+    BlockID getBlock(BlockCoord x, BlockCoord y, BlockCoord z) const;
+    void setBlock(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block);
+
+    // Returns the first non-air block along the ray within maxDistance, the double origin matches World::raycast
+    std::optional<RaycastHit> raycast(const glm::dvec3& origin, const glm::vec3& direction, float maxDistance) const;
+
+    // Visits every non-air block inside the box, fn(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block)
+    template <typename Fn>
+    void forEachBlock(const BlockBox& box, Fn&& fn) const;
+
+    std::size_t getNodeCount() const;
+    std::size_t getMemoryUsage() const;
+
+private:
+    struct Node
+    {
+        // Index of the first node of the child brick, 0 for leaves
+        std::uint32_t children{};
+        BlockID block{ Blocks::air };
+    };
+
+    // Deepest node containing a position, with its size and minimum corner in tree space
+    struct NodeLookup
+    {
+        const Node* node{};
+        int sizeLog2{};
+        glm::ivec3 min{};
+    };
+
+    static bool isInside(BlockCoord x, BlockCoord y, BlockCoord z);
+    static int childSlot(const glm::ivec3& treePos, int childLog2);
+
+    NodeLookup lookup(const glm::ivec3& treePos) const;
+
+    std::uint32_t allocateBrick(BlockID fill);
+    void freeBrick(std::uint32_t brick);
+
+    template <typename Fn>
+    void visitNode(std::uint32_t nodeIndex, int sizeLog2, const glm::ivec3& nodeMin,
+        const glm::ivec3& min, const glm::ivec3& max, Fn& fn) const;
+
+    // Slot 0 is the root, bricks start at index 8 so 0 can mean "no children"
+    std::vector<Node> m_nodes{};
+    std::vector<std::uint32_t> m_freeBricks{};
+};
+
+template <typename Fn>
+void OctreeWorld::forEachBlock(const BlockBox& box, Fn&& fn) const
+{
+    // Clipped to the tree before narrowing to tree space ints, nothing outside it is stored
+    using OctreeConstants::halfExtent;
+    const auto toTree = [](BlockCoord coord) {
+        return static_cast<int>(std::clamp(coord, -halfExtent - 1, halfExtent) + halfExtent);
+    };
+
+    const glm::ivec3 min{ toTree(box.min.x), toTree(box.min.y), toTree(box.min.z) };
+    const glm::ivec3 max{ toTree(box.max.x), toTree(box.max.y), toTree(box.max.z) };
+    visitNode(0, OctreeConstants::rootLog2, glm::ivec3{ 0 }, min, max, fn);
+}
+
+template <typename Fn>
+void OctreeWorld::visitNode(std::uint32_t nodeIndex, int sizeLog2, const glm::ivec3& nodeMin,
+    const glm::ivec3& min, const glm::ivec3& max, Fn& fn) const
+{
+    const glm::ivec3 nodeMax{ nodeMin + glm::ivec3{ (1 << sizeLog2) - 1 } };
+    if (glm::any(glm::greaterThan(nodeMin, max)) || glm::any(glm::lessThan(nodeMax, min)))
+        return;
+
+    const Node& node{ m_nodes[nodeIndex] };
+    if (node.children == 0)
+    {
+        // Empty space is skipped as a whole, solid leaves are clipped to the region
+        if (node.block == Blocks::air)
+            return;
+
+        const glm::ivec3 from{ glm::max(nodeMin, min) };
+        const glm::ivec3 to{ glm::min(nodeMax, max) };
+        for (int y{ from.y }; y <= to.y; ++y)
+            for (int z{ from.z }; z <= to.z; ++z)
+                for (int x{ from.x }; x <= to.x; ++x)
+                    fn(BlockCoord{ x } - OctreeConstants::halfExtent, BlockCoord{ y } - OctreeConstants::halfExtent,
+                        BlockCoord{ z } - OctreeConstants::halfExtent, node.block);
+        return;
+    }
+
+    const int childLog2{ sizeLog2 - 1 };
+    for (int slot{ 0 }; slot < 8; ++slot)
+    {
+        const glm::ivec3 childMin{ nodeMin + glm::ivec3{ slot & 1, (slot >> 1) & 1, (slot >> 2) & 1 } * (1 << childLog2) };
+        visitNode(node.children + slot, childLog2, childMin, min, max, fn);
+    }
+}
+
+#endif // !OCTREE_WORLD_H
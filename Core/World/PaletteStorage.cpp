@@ -0,0 +1,512 @@
+#include "PaletteStorage.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "BlockKernels.h"
+
+// === Helper Functions === //
+namespace
+{
+    constexpr std::size_t wordCount(int bits)
+    {
+        return static_cast<std::size_t>(ChunkConstants::volume) * bits / 64;
+    }
+
+    // Smallest supported width able to address entryCount palette entries
+    int bitsForEntries(std::size_t entryCount)
+    {
+        if (entryCount <= 1)
+            return PaletteConstants::uniformBits;
+
+        int bits{ PaletteConstants::minBits };
+        while (bits <= PaletteConstants::maxPaletteBits && (std::size_t{ 1 } << bits) < entryCount)
+            bits *= 2;
+
+        return bits > PaletteConstants::maxPaletteBits ? PaletteConstants::directBits : bits;
+    }
+
+    // Unrolled per width so the hot loop has constant shifts and masks, direct storage passes no palette
+    template <int Bits>
+    void decodeWords(std::span<const std::uint64_t> data, const BlockID* palette, BlockID* out)
+    {
+        constexpr int perWord{ 64 / Bits };
+        constexpr std::uint64_t mask{ (std::uint64_t{ 1 } << Bits) - 1 };
+
+        for (std::uint64_t word : data)
+        {
+            for (int i{ 0 }; i < perWord; ++i)
+            {
+                const auto index{ static_cast<std::size_t>(word & mask) };
+                if constexpr (Bits == PaletteConstants::directBits)
+                    *out++ = static_cast<BlockID>(index);
+                else
+                    *out++ = palette[index];
+                word >>= Bits;
+            }
+        }
+    }
+
+    // Mirror of decodeWords, each word is assembled in a register rather than written index by index
+    template <int Bits>
+    void encodeWords(const BlockID* blocks, std::span<const BlockID> palette, std::span<std::uint64_t> data)
+    {
+        constexpr int perWord{ 64 / Bits };
+
+        // Consecutive voxels are usually the same block, the last entry is checked before searching
+        std::size_t lastEntry{ 0 };
+        for (std::uint64_t& word : data)
+        {
+            std::uint64_t packed{ 0 };
+            for (int i{ 0 }; i < perWord; ++i)
+            {
+                const BlockID block{ *blocks++ };
+                if constexpr (Bits == PaletteConstants::directBits)
+                {
+                    packed |= std::uint64_t{ block } << (i * Bits);
+                }
+                else
+                {
+                    if (palette[lastEntry] != block)
+                        lastEntry = static_cast<std::size_t>(std::find(palette.begin(), palette.end(), block) - palette.begin());
+
+                    packed |= std::uint64_t{ lastEntry } << (i * Bits);
+                }
+            }
+            word = packed;
+        }
+    }
+
+    // Voxels per index value, counts has room for every value the width can hold
+    template <int Bits>
+    void countIndices(std::span<const std::uint64_t> data, std::uint16_t* counts)
+    {
+        constexpr int perByte{ 8 / Bits };
+        constexpr int mask{ (1 << Bits) - 1 };
+
+        // Whole bytes go to four interleaved tables, so a long run of one value doesn't wait on a single counter
+        std::uint32_t byteCounts[4][256]{};
+        for (std::uint64_t word : data)
+        {
+            for (int i{ 0 }; i < 8; ++i)
+                ++byteCounts[i & 3][(word >> (i * 8)) & 0xFF];
+        }
+
+        for (int value{ 0 }; value < 256; ++value)
+        {
+            const std::uint32_t seen{ byteCounts[0][value] + byteCounts[1][value] + byteCounts[2][value] + byteCounts[3][value] };
+            for (int i{ 0 }; seen != 0 && i < perByte; ++i)
+                counts[(value >> (i * Bits)) & mask] += static_cast<std::uint16_t>(seen);
+        }
+    }
+}
+
+// === PaletteStorage Class === //
+PaletteStorage::PaletteStorage(BlockID fillBlock)
+{
+    fill(fillBlock);
+}
+
+BlockID PaletteStorage::get(int index) const
+{
+    if (isUniform())
+        return m_uniformBlock;
+
+    const std::uint32_t value{ readIndex(index) };
+    return isDirect() ? static_cast<BlockID>(value) : m_palette[value];
+}
+
+BlockID PaletteStorage::set(int index, BlockID block)
+{
+    if (isUniform())
+    {
+        if (block == m_uniformBlock)
+            return block;
+
+        promote();
+    }
+
+    if (isDirect())
+    {
+        const auto previous{ static_cast<BlockID>(readIndex(index)) };
+        writeIndex(index, block);
+        return previous;
+    }
+
+    std::uint32_t oldEntry{ readIndex(index) };
+    const BlockID previous{ m_palette[oldEntry] };
+    if (previous == block)
+        return previous;
+
+    std::uint32_t newEntry{};
+    if (!findEntry(block, newEntry))
+    {
+        // The voxel held the last use of its entry, recycle the slot in place
+        if (m_counts[oldEntry] == 1)
+        {
+            m_palette[oldEntry] = block;
+            return previous;
+        }
+
+        // Every slot at this width is in use, widen before adding
+        if (m_liveEntries >= (std::size_t{ 1 } << m_bitsPerEntry))
+        {
+            repack(m_liveEntries + 1);
+            if (isDirect())
+            {
+                writeIndex(index, block);
+                return previous;
+            }
+
+            oldEntry = readIndex(index);
+        }
+
+        newEntry = addEntry(block);
+    }
+
+    if (--m_counts[oldEntry] == 0)
+        --m_liveEntries;
+    if (m_counts[newEntry]++ == 0)
+        ++m_liveEntries;
+
+    writeIndex(index, newEntry);
+
+    // The last differing voxel was overwritten, drop back to a single id
+    if (m_liveEntries == 1)
+    {
+        fill(block);
+        return previous;
+    }
+
+    // Shrinks keep one doubling of headroom so a block flickering in and out doesn't repack every edit
+    if (bitsForEntries(m_liveEntries * 2) < m_bitsPerEntry)
+        repack(0);
+
+    return previous;
+}
+
+void PaletteStorage::fill(BlockID block)
+{
+    m_bitsPerEntry = PaletteConstants::uniformBits;
+    m_uniformBlock = block;
+    m_liveEntries = 1;
+
+    // Uniform storage releases its buffers entirely
+    m_palette.release();
+    m_counts.release();
+    m_data.release();
+}
+
+void PaletteStorage::decode(std::span<BlockID> out) const
+{
+    assert(out.size() >= static_cast<std::size_t>(ChunkConstants::volume));
+
+    if (isUniform())
+    {
+        std::fill_n(out.begin(), ChunkConstants::volume, m_uniformBlock);
+        return;
+    }
+
+    const BlockID* palette{ isDirect() ? nullptr : m_palette.data() };
+    switch (m_bitsPerEntry)
+    {
+    case 1:  decodeWords<1>(m_data, palette, out.data()); break;
+    case 2:  decodeWords<2>(m_data, palette, out.data()); break;
+    case 4:  decodeWords<4>(m_data, palette, out.data()); break;
+    case 8:  decodeWords<8>(m_data, palette, out.data()); break;
+    default: decodeWords<16>(m_data, palette, out.data()); break;
+    }
+}
+
+void PaletteStorage::encode(std::span<const BlockID> blocks)
+{
+    encodeBlocks(blocks, 0);
+}
+
+void PaletteStorage::encodeBlocks(std::span<const BlockID> blocks, std::size_t reserveEntries)
+{
+    assert(blocks.size() >= static_cast<std::size_t>(ChunkConstants::volume));
+
+    // First pass builds the palette, consecutive voxels are usually the same block so counts are
+    // kept per run in a register rather than incremented in memory for every voxel
+    PooledVector<BlockID> palette{};
+    PooledVector<std::uint16_t> counts{};
+    palette.push_back(blocks[0]);
+    counts.push_back(0);
+    std::size_t lastEntry{ 0 };
+    std::size_t run{ 0 };
+
+    for (int i{ 0 }; i < ChunkConstants::volume; ++i)
+    {
+        const BlockID block{ blocks[i] };
+        if (palette[lastEntry] != block)
+        {
+            counts[lastEntry] = static_cast<std::uint16_t>(counts[lastEntry] + run);
+            run = 0;
+
+            auto it{ std::find(palette.begin(), palette.end(), block) };
+            lastEntry = static_cast<std::size_t>(it - palette.begin());
+            if (it == palette.end())
+            {
+                palette.push_back(block);
+                counts.push_back(0);
+            }
+        }
+        ++run;
+    }
+    counts[lastEntry] = static_cast<std::uint16_t>(counts[lastEntry] + run);
+
+    if (palette.size() == 1 && reserveEntries <= 1)
+    {
+        fill(palette.front());
+        return;
+    }
+
+    m_bitsPerEntry = bitsForEntries(std::max(palette.size(), reserveEntries));
+    m_liveEntries = palette.size();
+    m_data = PooledBuffer<std::uint64_t>{ wordCount(m_bitsPerEntry) };
+
+    if (isDirect())
+    {
+        m_palette.release();
+        m_counts.release();
+        encodeWords<PaletteConstants::directBits>(blocks.data(), {}, m_data);
+        return;
+    }
+
+    m_palette = std::move(palette);
+    m_counts = std::move(counts);
+
+    // Second pass writes the indices
+    switch (m_bitsPerEntry)
+    {
+    case 1:  encodeWords<1>(blocks.data(), m_palette, m_data); break;
+    case 2:  encodeWords<2>(blocks.data(), m_palette, m_data); break;
+    case 4:  encodeWords<4>(blocks.data(), m_palette, m_data); break;
+    default: encodeWords<8>(blocks.data(), m_palette, m_data); break;
+    }
+}
+
+int PaletteStorage::getBitsPerEntry() const
+{
+    return m_bitsPerEntry;
+}
+
+std::size_t PaletteStorage::getPaletteSize() const
+{
+    return isDirect() ? 0 : m_liveEntries;
+}
+
+std::size_t PaletteStorage::getMemoryUsage() const
+{
+    return m_data.sizeBytes()
+        + m_palette.capacity() * sizeof(BlockID)
+        + m_counts.capacity() * sizeof(std::uint16_t);
+}
+
+std::span<const BlockID> PaletteStorage::getPalette() const
+{
+    return m_palette;
+}
+
+std::span<const std::uint16_t> PaletteStorage::getCounts() const
+{
+    return m_counts;
+}
+
+std::span<const std::uint64_t> PaletteStorage::getWords() const
+{
+    return m_data;
+}
+
+bool PaletteStorage::assign(int bitsPerEntry, BlockID uniformBlock, std::span<const BlockID> palette,
+    std::span<const std::uint16_t> counts, std::span<const std::uint64_t> words, PaletteConstants::Counts check)
+{
+    if (bitsPerEntry == PaletteConstants::uniformBits)
+    {
+        fill(uniformBlock);
+        return true;
+    }
+
+    const bool direct{ bitsPerEntry == PaletteConstants::directBits };
+    const bool validWidth{ direct || (bitsPerEntry <= PaletteConstants::maxPaletteBits && std::has_single_bit(static_cast<unsigned>(bitsPerEntry))) };
+    if (!validWidth || words.size() != wordCount(bitsPerEntry) || palette.size() != counts.size())
+        return false;
+
+    if (direct != palette.empty() || palette.size() > (std::size_t{ 1 } << (direct ? 0 : bitsPerEntry)))
+        return false;
+
+    // Counts drive entry reuse in set, so unless trusted they are recounted from the indices
+    const bool recount{ check == PaletteConstants::recountIndices };
+    std::uint16_t recounted[std::size_t{ 1 } << PaletteConstants::maxPaletteBits]{};
+    switch (direct || !recount ? 0 : bitsPerEntry)
+    {
+    case 0:  break;
+    case 1:  countIndices<1>(words, recounted); break;
+    case 2:  countIndices<2>(words, recounted); break;
+    case 4:  countIndices<4>(words, recounted); break;
+    default: countIndices<8>(words, recounted); break;
+    }
+
+    std::size_t live{ 0 };
+    std::size_t lastLive{ 0 };
+    std::size_t total{ 0 };
+    BlockID liveBlocks[std::size_t{ 1 } << PaletteConstants::maxPaletteBits]{};
+    for (std::size_t entry{ 0 }; !direct && entry < (std::size_t{ 1 } << bitsPerEntry); ++entry)
+    {
+        const std::uint16_t expected{ entry < counts.size() ? counts[entry] : std::uint16_t{ 0 } };
+        if (recount && recounted[entry] != expected)
+            return false;
+
+        if (expected == 0)
+            continue;
+
+        total += expected;
+        liveBlocks[live++] = palette[entry];
+        lastLive = entry;
+    }
+
+    // Trusted counts still have to cover every voxel exactly once
+    if (!direct && total != ChunkConstants::volume)
+        return false;
+
+    // Live entries are distinct blocks, a duplicate would split one block's count in two
+    std::sort(liveBlocks, liveBlocks + live);
+    if (std::adjacent_find(liveBlocks, liveBlocks + live) != liveBlocks + live)
+        return false;
+
+    // A single block is kept uniform like every other path, so content checks can rely on it
+    if (live == 1)
+    {
+        fill(palette[lastLive]);
+        return true;
+    }
+
+    // Direct words holding one id four times over, every word alike
+    if (direct && (words[0] & 0xFFFF) * 0x0001000100010001ull == words[0]
+        && std::all_of(words.begin(), words.end(), [&](std::uint64_t word) { return word == words[0]; }))
+    {
+        fill(static_cast<BlockID>(words[0] & 0xFFFF));
+        return true;
+    }
+
+    m_bitsPerEntry = bitsPerEntry;
+    m_liveEntries = direct ? 0 : live;
+    m_palette.assign(palette.begin(), palette.end());
+    m_counts.assign(counts.begin(), counts.end());
+
+    // Unused index values get free slots, so a later set can claim them
+    if (!direct)
+    {
+        m_palette.resize(std::size_t{ 1 } << bitsPerEntry, Blocks::air);
+        m_counts.resize(m_palette.size(), 0);
+    }
+
+    m_data = PooledBuffer<std::uint64_t>{ words.size() };
+    std::copy(words.begin(), words.end(), m_data.data());
+    return true;
+}
+
+bool PaletteStorage::isUniform() const
+{
+    return m_bitsPerEntry == PaletteConstants::uniformBits;
+}
+
+BlockID PaletteStorage::getUniformBlock() const
+{
+    return m_uniformBlock;
+}
+
+std::size_t PaletteStorage::countOf(BlockID block) const
+{
+    if (isUniform())
+        return block == m_uniformBlock ? ChunkConstants::volume : 0;
+
+    if (isDirect())
+    {
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+        decode(blocks);
+        return BlockKernels::countEqual(blocks.data(), blocks.size(), block);
+    }
+
+    std::uint32_t entry{};
+    return findEntry(block, entry) ? m_counts[entry] : 0;
+}
+
+bool PaletteStorage::mayContain(BlockID block) const
+{
+    if (isUniform())
+        return block == m_uniformBlock;
+
+    std::uint32_t entry{};
+    return isDirect() || findEntry(block, entry);
+}
+
+bool PaletteStorage::isDirect() const
+{
+    return m_bitsPerEntry > PaletteConstants::maxPaletteBits;
+}
+
+std::uint32_t PaletteStorage::readIndex(int index) const
+{
+    const auto bitOffset{ static_cast<std::size_t>(index) * m_bitsPerEntry };
+    const std::uint64_t mask{ (std::uint64_t{ 1 } << m_bitsPerEntry) - 1 };
+    return static_cast<std::uint32_t>((m_data[bitOffset >> 6] >> (bitOffset & 63)) & mask);
+}
+
+void PaletteStorage::writeIndex(int index, std::uint32_t value)
+{
+    const auto bitOffset{ static_cast<std::size_t>(index) * m_bitsPerEntry };
+    const std::uint64_t mask{ (std::uint64_t{ 1 } << m_bitsPerEntry) - 1 };
+    std::uint64_t& word{ m_data[bitOffset >> 6] };
+    word = (word & ~(mask << (bitOffset & 63))) | ((value & mask) << (bitOffset & 63));
+}
+
+bool PaletteStorage::findEntry(BlockID block, std::uint32_t& entry) const
+{
+    for (std::size_t i{ 0 }; i < m_palette.size(); ++i)
+    {
+        if (m_counts[i] != 0 && m_palette[i] == block)
+        {
+            entry = static_cast<std::uint32_t>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::uint32_t PaletteStorage::addEntry(BlockID block)
+{
+    auto it{ std::find(m_counts.begin(), m_counts.end(), std::uint16_t{ 0 }) };
+    if (it != m_counts.end())
+    {
+        const auto entry{ static_cast<std::size_t>(it - m_counts.begin()) };
+        m_palette[entry] = block;
+        return static_cast<std::uint32_t>(entry);
+    }
+
+    m_palette.push_back(block);
+    m_counts.push_back(0);
+    return static_cast<std::uint32_t>(m_palette.size() - 1);
+}
+
+void PaletteStorage::repack(std::size_t reserveEntries)
+{
+    PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+    decode(blocks);
+
+    // Freed entries are dropped here since the palette is rebuilt from the voxels themselves
+    encodeBlocks(blocks, reserveEntries);
+}
+
+void PaletteStorage::promote()
+{
+    m_bitsPerEntry = PaletteConstants::minBits;
+    m_palette.assign(1, m_uniformBlock);
+    m_counts.assign(1, static_cast<std::uint16_t>(ChunkConstants::volume));
+    m_liveEntries = 1;
+    m_data = PooledBuffer<std::uint64_t>{ wordCount(m_bitsPerEntry) };
+    std::fill_n(m_data.data(), m_data.size(), 0);
+}
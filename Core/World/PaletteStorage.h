@@ -0,0 +1,126 @@
+#ifndef PALETTE_STORAGE_H
+#define PALETTE_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Block.h"
+#include "ChunkPool.h"
+#include "Coordinates.h"
+
+namespace PaletteConstants
+{
+    // A chunk holding a single block type stores no indices at all
+    inline constexpr int uniformBits{ 0 };
+
+    // Index widths always divide 64 so an entry never straddles two words
+    inline constexpr int minBits{ 1 };
+    inline constexpr int maxPaletteBits{ 8 };
+
+    // Past 8 bits the palette is dropped and block ids are stored directly,
+    // direct storage stays direct until the next fill or encode
+    inline constexpr int directBits{ 16 };
+
+    // How assign treats the counts it's given: rebuilt from the indices, or taken as stored once they sum to the volume
+    enum Counts
+    {
+        recountIndices,
+        trustCounts,
+    };
+}
+
+/*
+    Stores one chunk worth of block ids as bit-packed indices into a per-chunk palette.
+
+    A chunk with two block types costs 4 KiB instead of 64 KiB. The index width grows
+    as new block types are written and shrinks again once palette entries stop being used.
+    All-air or all-stone chunks are kept uniform, holding just one block id and no heap memory,
+    until the first differing write promotes them.
+*/
+class PaletteStorage
+{
+public:
+    // Constructor, every voxel starts as fillBlock
+    explicit PaletteStorage(BlockID fillBlock = Blocks::air);
+
+    // Voxel access by flat index (see Coordinates::localToIndex)
+    BlockID get(int index) const;
+
+    // Returns the block that was replaced
+    BlockID set(int index, BlockID block);
+
+    void fill(BlockID block);
+
+    // Bulk conversion between packed indices and a flat array of ChunkConstants::volume ids
+    void decode(std::span<BlockID> out) const;
+    void encode(std::span<const BlockID> blocks);
+
+    int getBitsPerEntry() const;
+
+    // Number of live palette entries, 0 in direct mode
+    std::size_t getPaletteSize() const;
+
+    // Uniform storage lets the mesher and lighting skip the chunk without decoding it
+    bool isUniform() const;
+    BlockID getUniformBlock() const;
+
+    // Voxels holding block, read off the palette counts; direct storage has to scan
+    std::size_t countOf(BlockID block) const;
+
+    // Exact for uniform and palette storage, direct storage answers true without scanning
+    bool mayContain(BlockID block) const;
+
+    std::size_t getMemoryUsage() const;
+
+    /*
+        Raw parts for serialization. The palette may hold free entries, those have a count of 0.
+        Words hold the packed indices in storage order, all three are empty for uniform storage.
+    */
+    std::span<const BlockID> getPalette() const;
+    std::span<const std::uint16_t> getCounts() const;
+    std::span<const std::uint64_t> getWords() const;
+
+    /*
+        Rebuilds from raw parts by copying them, without decoding to block ids. Sizes are checked and
+        counts recounted from the indices unless trusted, returns false and leaves the storage
+        untouched when they don't agree. A palette with one live entry comes back uniform.
+        Pass an empty palette for direct storage and uniformBlock alone for uniform storage.
+    */
+    bool assign(int bitsPerEntry, BlockID uniformBlock, std::span<const BlockID> palette,
+        std::span<const std::uint16_t> counts, std::span<const std::uint64_t> words,
+        PaletteConstants::Counts check = PaletteConstants::recountIndices);
+
+private:
+    bool isDirect() const;
+
+    std::uint32_t readIndex(int index) const;
+    void writeIndex(int index, std::uint32_t value);
+
+    // Looks up a live palette entry, entries with a zero count are free slots
+    bool findEntry(BlockID block, std::uint32_t& entry) const;
+
+    // Claims a free slot or appends, the caller guarantees the current width has room
+    std::uint32_t addEntry(BlockID block);
+
+    // Re-packs at the narrowest width holding max(live entries, reserveEntries), compacting the palette
+    void repack(std::size_t reserveEntries);
+    void encodeBlocks(std::span<const BlockID> blocks, std::size_t reserveEntries);
+
+    // Switches from uniform to 1-bit indices, every voxel pointing at entry 0
+    void promote();
+
+    int m_bitsPerEntry{ PaletteConstants::uniformBits };
+    std::size_t m_liveEntries{};
+    BlockID m_uniformBlock{ Blocks::air };
+
+    // Palette and per-entry voxel counts, both unused in uniform and direct mode; pooled like the indices
+    PooledVector<BlockID> m_palette{};
+    PooledVector<std::uint16_t> m_counts{};
+
+    // Packed indices, 4 KiB per bit of width, allocated from ChunkPool
+    PooledBuffer<std::uint64_t> m_data{};
+};
+
+#endif // !PALETTE_STORAGE_H
@@ -0,0 +1,20 @@
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "Coordinates.h"
+
+// Result of a voxel raycast, the normal points out of the face the ray entered through
+struct RaycastHit
+{
+    BlockCoord x{};
+    BlockCoord y{};
+    BlockCoord z{};
+    BlockID block{ Blocks::air };
+    glm::ivec3 normal{};
+    float distance{};
+};
+
+#endif // !RAYCAST_H
@@ -0,0 +1,393 @@
+#include "RegionFile.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <system_error>
+
+// === Helper Functions === //
+namespace
+{
+    using RegionConstants::sectorSize;
+
+    constexpr std::uint32_t sectorsFor(std::size_t bytes)
+    {
+        return static_cast<std::uint32_t>((bytes + sectorSize - 1) / sectorSize);
+    }
+
+    // Header and table together, payloads start right after
+    constexpr std::uint32_t headerSectors{ sectorsFor(sizeof(RegionHeader) + RegionConstants::chunkCount * sizeof(RegionEntry)) };
+
+    // Pads with zeros up to the next sector boundary, so the file length stays a whole number of sectors
+    void writePadded(std::ostream& out, const void* data, std::size_t bytes)
+    {
+        static constexpr std::array<char, sectorSize> zeros{};
+
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        const std::size_t padding{ sectorsFor(bytes) * sectorSize - bytes };
+        out.write(zeros.data(), static_cast<std::streamsize>(padding));
+    }
+
+    void writeHeader(std::ostream& out, ChunkCoord region, const std::vector<RegionEntry>& entries)
+    {
+        const RegionHeader header{ .x = region.x, .y = region.y, .z = region.z };
+
+        std::vector<std::byte> bytes(headerSectors * sectorSize);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::memcpy(bytes.data() + sizeof(header), entries.data(), entries.size() * sizeof(RegionEntry));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+// === RegionFile Class === //
+RegionFile::RegionFile(std::filesystem::path path, ChunkCoord region)
+    : m_path{ std::move(path) }
+    , m_region{ region }
+    , m_entries(RegionConstants::chunkCount)
+{
+    std::error_code error{};
+    if (!std::filesystem::exists(m_path, error))
+    {
+        std::ofstream created{ m_path, std::ios::binary };
+        writeHeader(created, m_region, m_entries);
+        if (!created)
+        {
+            std::cout << "Failed to create region file: " << m_path.string() << '\n';
+            return;
+        }
+    }
+
+    m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+    m_open = m_file && load();
+    if (!m_open)
+        std::cout << "Failed to open region file: " << m_path.string() << '\n';
+}
+
+ChunkCoord RegionFile::regionOf(ChunkCoord chunk)
+{
+    using namespace RegionConstants;
+    return ChunkCoord{ chunk.x >> widthLog2, chunk.y >> heightLog2, chunk.z >> widthLog2 };
+}
+
+std::string RegionFile::nameFor(ChunkCoord region)
+{
+    return "r." + std::to_string(region.x) + '.' + std::to_string(region.y) + '.' + std::to_string(region.z) + ".region";
+}
+
+std::optional<ChunkCoord> RegionFile::parseName(const std::filesystem::path& path)
+{
+    if (path.extension() != ".region")
+        return std::nullopt;
+
+    const std::string stem{ path.stem().string() };
+    const std::string_view name{ stem };
+    if (!name.starts_with("r."))
+        return std::nullopt;
+
+    ChunkCoord region{};
+    BlockCoord* components[]{ &region.x, &region.y, &region.z };
+    const char* it{ name.data() + 2 };
+    const char* end{ name.data() + name.size() };
+
+    for (int i{ 0 }; i < 3; ++i)
+    {
+        if (i != 0)
+        {
+            if (it == end || *it != '.')
+                return std::nullopt;
+            ++it;
+        }
+
+        auto [next, error]{ std::from_chars(it, end, *components[i]) };
+        if (error != std::errc{})
+            return std::nullopt;
+        it = next;
+    }
+
+    if (it != end)
+        return std::nullopt;
+
+    return region;
+}
+
+bool RegionFile::isOpen() const
+{
+    return m_open;
+}
+
+ChunkCoord RegionFile::getRegion() const
+{
+    return m_region;
+}
+
+bool RegionFile::contains(ChunkCoord chunk) const
+{
+    return m_entries[slotOf(chunk)].sector != 0;
+}
+
+bool RegionFile::read(ChunkCoord chunk, std::vector<std::byte>& payload)
+{
+    const RegionEntry& entry{ m_entries[slotOf(chunk)] };
+    if (!m_open || entry.sector == 0)
+        return false;
+
+    payload.resize(entry.size);
+    m_file.seekg(static_cast<std::streamoff>(entry.sector) * sectorSize);
+    m_file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (!m_file)
+    {
+        m_file.clear();
+        std::cout << "Failed to read chunk from region file: " << m_path.string() << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+bool RegionFile::write(ChunkCoord chunk, std::span<const std::byte> payload)
+{
+    if (!m_open || payload.empty() || payload.size() > RegionConstants::maxPayloadBytes)
+        return false;
+
+    const int slot{ slotOf(chunk) };
+    const RegionEntry previous{ m_entries[slot] };
+    const std::uint32_t previousSectors{ sectorsFor(previous.size) };
+    const std::uint32_t sectors{ sectorsFor(payload.size()) };
+
+    // Overwritten in place when it still fits, a move never touches the sectors of the old payload
+    const bool inPlace{ previous.sector != 0 && sectors <= previousSectors };
+    const std::uint32_t first{ inPlace ? previous.sector : allocate(sectors) };
+
+    m_file.seekp(static_cast<std::streamoff>(first) * sectorSize);
+    writePadded(m_file, payload.data(), payload.size());
+    m_file.flush();
+    if (!m_file)
+    {
+        m_file.clear();
+        std::cout << "Failed to write chunk to region file: " << m_path.string() << '\n';
+        return false;
+    }
+
+    m_entries[slot] = RegionEntry{ first, static_cast<std::uint32_t>(payload.size()) };
+    if (!writeEntry(slot))
+    {
+        m_entries[slot] = previous;
+        return false;
+    }
+
+    // A shrunk payload frees its tail, a moved one its whole old run once the table points elsewhere
+    if (inPlace)
+    {
+        markSectors(first + sectors, previousSectors - sectors, false);
+    }
+    else
+    {
+        if (previous.sector != 0)
+            markSectors(previous.sector, previousSectors, false);
+        markSectors(first, sectors, true);
+    }
+
+    return true;
+}
+
+bool RegionFile::erase(ChunkCoord chunk)
+{
+    const int slot{ slotOf(chunk) };
+    const RegionEntry previous{ m_entries[slot] };
+    if (!m_open || previous.sector == 0)
+        return false;
+
+    m_entries[slot] = RegionEntry{};
+    if (!writeEntry(slot))
+    {
+        m_entries[slot] = previous;
+        return false;
+    }
+
+    markSectors(previous.sector, sectorsFor(previous.size), false);
+    return true;
+}
+
+bool RegionFile::compact()
+{
+    if (!m_open)
+        return false;
+
+    std::filesystem::path temporary{ m_path };
+    temporary += ".tmp";
+
+    // Written beside the original and renamed over it, a failure part way leaves the original intact
+    std::error_code error{};
+    std::vector<RegionEntry> entries(RegionConstants::chunkCount);
+    {
+        std::ofstream out{ temporary, std::ios::binary | std::ios::trunc };
+        writeHeader(out, m_region, entries);
+
+        std::uint32_t next{ headerSectors };
+        std::vector<std::byte> payload{};
+        for (int slot{ 0 }; slot < RegionConstants::chunkCount; ++slot)
+        {
+            if (m_entries[slot].sector == 0)
+                continue;
+
+            // A chunk that can't be read is never dropped, the original file is kept as it is
+            if (!read(chunkAt(slot), payload))
+            {
+                out.close();
+                std::filesystem::remove(temporary, error);
+                std::cout << "Aborted compacting region file: " << m_path.string() << '\n';
+                return false;
+            }
+
+            writePadded(out, payload.data(), payload.size());
+            entries[slot] = RegionEntry{ next, static_cast<std::uint32_t>(payload.size()) };
+            next += sectorsFor(payload.size());
+        }
+
+        writeHeader(out, m_region, entries);
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            std::cout << "Failed to write compacted region file: " << temporary.string() << '\n';
+            return false;
+        }
+    }
+
+    m_file.close();
+    std::filesystem::rename(temporary, m_path, error);
+    if (error)
+        std::cout << "Failed to replace region file: " << m_path.string() << '\n';
+
+    // Reopened either way, on failure the original is still in place
+    m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+    m_open = m_file && load();
+    return m_open && !error;
+}
+
+std::size_t RegionFile::getSectorCount() const
+{
+    return m_usedSectors.size();
+}
+
+std::size_t RegionFile::getFreeSectorCount() const
+{
+    std::size_t free{ 0 };
+    for (bool used : m_usedSectors)
+        free += !used;
+
+    return free;
+}
+
+int RegionFile::slotOf(ChunkCoord chunk)
+{
+    using namespace RegionConstants;
+    const int x{ static_cast<int>(chunk.x & (width - 1)) };
+    const int y{ static_cast<int>(chunk.y & (height - 1)) };
+    const int z{ static_cast<int>(chunk.z & (width - 1)) };
+    return (y * width + z) * width + x;
+}
+
+ChunkCoord RegionFile::chunkAt(int slot) const
+{
+    using namespace RegionConstants;
+    return ChunkCoord{
+        (m_region.x << widthLog2) + (slot & (width - 1)),
+        (m_region.y << heightLog2) + (slot >> (2 * widthLog2)),
+        (m_region.z << widthLog2) + ((slot >> widthLog2) & (width - 1))
+    };
+}
+
+bool RegionFile::load()
+{
+    RegionHeader header{};
+    m_file.seekg(0);
+    m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    m_file.read(reinterpret_cast<char*>(m_entries.data()), static_cast<std::streamsize>(m_entries.size() * sizeof(RegionEntry)));
+
+    const bool valid{ header.magic == RegionConstants::magic && header.version == RegionConstants::formatVersion };
+    if (!m_file || !valid || header.x != m_region.x || header.y != m_region.y || header.z != m_region.z)
+    {
+        m_file.clear();
+        return false;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    const std::uint32_t fileSectors{ sectorsFor(static_cast<std::size_t>(m_file.tellg())) };
+    m_usedSectors.assign(std::max(fileSectors, headerSectors), false);
+    markSectors(0, headerSectors, true);
+
+    // Entries pointing outside the file or into sectors already taken are dropped, not trusted
+    for (RegionEntry& entry : m_entries)
+    {
+        if (entry.sector == 0)
+            continue;
+
+        const std::uint32_t sectors{ sectorsFor(entry.size) };
+        bool usable{ entry.size != 0 && entry.size <= RegionConstants::maxPayloadBytes && entry.sector >= headerSectors
+            && entry.sector + sectors <= m_usedSectors.size() };
+        for (std::uint32_t sector{ entry.sector }; usable && sector < entry.sector + sectors; ++sector)
+            usable = !m_usedSectors[sector];
+
+        if (!usable)
+        {
+            std::cout << "Dropping corrupt chunk entry in region file: " << m_path.string() << '\n';
+            entry = RegionEntry{};
+            continue;
+        }
+
+        markSectors(entry.sector, sectors, true);
+    }
+
+    return true;
+}
+
+std::uint32_t RegionFile::allocate(std::uint32_t sectors)
+{
+    // A free run reaching the end of the file can be extended past it
+    std::uint32_t runStart{ 0 };
+    std::uint32_t runLength{ 0 };
+    for (std::uint32_t sector{ headerSectors }; sector < m_usedSectors.size(); ++sector)
+    {
+        if (m_usedSectors[sector])
+        {
+            runLength = 0;
+            continue;
+        }
+
+        if (runLength++ == 0)
+            runStart = sector;
+        if (runLength == sectors)
+            return runStart;
+    }
+
+    return runLength != 0 ? runStart : static_cast<std::uint32_t>(m_usedSectors.size());
+}
+
+void RegionFile::markSectors(std::uint32_t first, std::uint32_t count, bool used)
+{
+    if (first + count > m_usedSectors.size())
+        m_usedSectors.resize(first + count, false);
+
+    std::fill_n(m_usedSectors.begin() + first, count, used);
+}
+
+bool RegionFile::writeEntry(int slot)
+{
+    m_file.seekp(static_cast<std::streamoff>(sizeof(RegionHeader) + slot * sizeof(RegionEntry)));
+    m_file.write(reinterpret_cast<const char*>(&m_entries[slot]), sizeof(RegionEntry));
+    m_file.flush();
+    if (!m_file)
+    {
+        m_file.clear();
+        std::cout << "Failed to update region file table: " << m_path.string() << '\n';
+        return false;
+    }
+
+    return true;
+}
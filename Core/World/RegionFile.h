@@ -0,0 +1,141 @@
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Coordinates.h"
+
+namespace RegionConstants
+{
+    // A region spans 32 x 8 x 32 chunks, a 1024 x 256 x 1024 block slab of the world
+    inline constexpr int widthLog2{ 5 };
+    inline constexpr int heightLog2{ 3 };
+    inline constexpr int width{ 1 << widthLog2 };
+    inline constexpr int height{ 1 << heightLog2 };
+    inline constexpr int chunkCount{ width * width * height };
+
+    inline constexpr std::size_t sectorSize{ 4096 };
+
+    inline constexpr std::uint32_t magic{ 0x47525856 }; // "VXRG" read little-endian
+    inline constexpr std::uint16_t formatVersion{ 1 };
+
+    // Sanity bound on one chunk's payload, checked before a size read from disk is trusted
+    inline constexpr std::uint32_t maxPayloadBytes{ 16u << 20 };
+}
+
+// Where one chunk's payload lives, sector 0 means the chunk isn't stored
+struct RegionEntry
+{
+    std::uint32_t sector{};
+    std::uint32_t size{};
+};
+
+struct RegionHeader
+{
+    std::uint32_t magic{ RegionConstants::magic };
+    std::uint16_t version{ RegionConstants::formatVersion };
+    std::uint16_t reserved{};
+
+    // Region coordinate, a file renamed to another region is refused
+    std::int64_t x{};
+    std::int64_t y{};
+    std::int64_t z{};
+};
+
+/*
+    Container for the chunks of one region, so the store keeps one file per region
+    instead of one per chunk.
+
+    The file starts with a header and a table of one entry per chunk slot, padded to whole
+    sectors. Payloads occupy runs of 4 KiB sectors. A payload that still fits its sectors is
+    overwritten in place, a larger one moves to the first free run large enough or the end of the
+    file. Writes are flushed to the OS but not synced, so a crash mid-write can tear the chunk being
+    written. Freed sectors are reused by later writes, compact() rewrites the file to reclaim what
+    is left. Integers are in host byte order.
+*/
+class RegionFile
+{
+public:
+    // No default constructor, a region file always has a path
+    RegionFile() = delete;
+
+    // Opens the file or creates an empty one, check isOpen afterwards
+    RegionFile(std::filesystem::path path, ChunkCoord region);
+
+    ~RegionFile() = default;
+
+    // Deleted copy and move operations, the open stream and the sector map belong to one file
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+    RegionFile(RegionFile&&) = delete;
+    RegionFile& operator=(RegionFile&&) = delete;
+
+    // Region coordinates are chunk coordinates shifted down by the region size
+    static ChunkCoord regionOf(ChunkCoord chunk);
+
+    // File names are "r.x.y.z.region"
+    static std::string nameFor(ChunkCoord region);
+    static std::optional<ChunkCoord> parseName(const std::filesystem::path& path);
+
+    bool isOpen() const;
+    ChunkCoord getRegion() const;
+
+    // The chunk has to lie in this region
+    bool contains(ChunkCoord chunk) const;
+
+    // All return false on failure. A moved payload keeps its old sectors until the table points at the new ones
+    bool read(ChunkCoord chunk, std::vector<std::byte>& payload);
+    bool write(ChunkCoord chunk, std::span<const std::byte> payload);
+    bool erase(ChunkCoord chunk);
+
+    // Rewrites the file with payloads back to back in slot order, dropping every free sector.
+    // Any chunk that fails to read aborts it, the temporary file is removed and the original kept
+    bool compact();
+
+    // fn(ChunkCoord chunk) for every stored chunk
+    template <typename Fn>
+    void forEachChunk(Fn&& fn) const
+    {
+        for (int slot{ 0 }; slot < RegionConstants::chunkCount; ++slot)
+        {
+            if (m_entries[slot].sector != 0)
+                fn(chunkAt(slot));
+        }
+    }
+
+    // File length in sectors, header included, and how many of them hold no payload
+    std::size_t getSectorCount() const;
+    std::size_t getFreeSectorCount() const;
+
+private:
+    static int slotOf(ChunkCoord chunk);
+    ChunkCoord chunkAt(int slot) const;
+
+    // Reads the header and table and rebuilds the sector map, false when the file doesn't check out
+    bool load();
+
+    // First run of free sectors long enough, or the end of the file
+    std::uint32_t allocate(std::uint32_t sectors);
+    void markSectors(std::uint32_t first, std::uint32_t count, bool used);
+
+    bool writeEntry(int slot);
+
+    std::filesystem::path m_path{};
+    ChunkCoord m_region{};
+    std::fstream m_file{};
+    bool m_open{ false };
+
+    std::vector<RegionEntry> m_entries{};
+
+    // One flag per sector of the file, the header's sectors are always used
+    std::vector<bool> m_usedSectors{};
+};
+
+#endif // !REGION_FILE_H
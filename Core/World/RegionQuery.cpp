@@ -0,0 +1,214 @@
+#include "RegionQuery.h"
+
+#include "BlockKernels.h"
+#include "PaletteStorage.h"
+#include "VoxelLayout.h"
+
+// === Helper Functions === //
+namespace
+{
+    std::size_t volumeOf(const LocalBox& box)
+    {
+        return static_cast<std::size_t>(box.max.x - box.min.x + 1)
+            * static_cast<std::size_t>(box.max.y - box.min.y + 1)
+            * static_cast<std::size_t>(box.max.z - box.min.z + 1);
+    }
+
+    bool coversChunk(const LocalBox& box)
+    {
+        return volumeOf(box) == ChunkConstants::volume;
+    }
+
+    WorldPos toWorld(ChunkCoord coord, LocalPos local)
+    {
+        return WorldPos{
+            Coordinates::chunkToWorld(coord.x, local.x),
+            Coordinates::chunkToWorld(coord.y, local.y),
+            Coordinates::chunkToWorld(coord.z, local.z)
+        };
+    }
+
+    // Calls fn(offset, length) for each run of the box that is contiguous in linear order
+    template <typename Fn>
+    void forEachSpan(const LocalBox& box, Fn&& fn)
+    {
+        using ChunkConstants::size;
+
+        const int width{ box.max.x - box.min.x + 1 };
+        const int depth{ box.max.z - box.min.z + 1 };
+
+        // Whole slices follow each other, the entire overlap is one run
+        if (width == size && depth == size)
+        {
+            fn(Coordinates::localToIndex(0, box.min.y, 0), (box.max.y - box.min.y + 1) * ChunkConstants::area);
+            return;
+        }
+
+        for (int y{ box.min.y }; y <= box.max.y; ++y)
+        {
+            // Whole rows follow each other within a slice
+            if (width == size)
+            {
+                fn(Coordinates::localToIndex(0, y, box.min.z), depth * size);
+                continue;
+            }
+
+            for (int z{ box.min.z }; z <= box.max.z; ++z)
+                fn(Coordinates::localToIndex(box.min.x, y, z), width);
+        }
+    }
+
+    // The buffer is only allocated once a chunk actually needs decoding
+    void decodeInto(PooledBuffer<BlockID>& blocks, const Chunk& chunk)
+    {
+        if (blocks.empty())
+            blocks = PooledBuffer<BlockID>{ ChunkConstants::volume };
+
+        chunk.decodeBlocks(blocks);
+    }
+}
+
+// === RegionQuery Functions === //
+std::size_t RegionQuery::count(const World& world, const BlockBox& box, BlockID block)
+{
+    std::size_t total{ 0 };
+    PooledBuffer<BlockID> blocks{};
+
+    forEachChunk(box, [&](ChunkCoord coord, const LocalBox& overlap) {
+        const Chunk* chunk{ world.getChunk(coord) };
+        if (!chunk)
+        {
+            if (block == Blocks::air)
+                total += volumeOf(overlap);
+            return;
+        }
+
+        const PaletteStorage& storage{ chunk->getStorage() };
+        if (!storage.mayContain(block))
+            return;
+
+        if (storage.isUniform())
+        {
+            total += volumeOf(overlap);
+            return;
+        }
+
+        // The palette keeps a use count per entry, a whole chunk needs no decode
+        if (coversChunk(overlap))
+        {
+            total += storage.countOf(block);
+            return;
+        }
+
+        decodeInto(blocks, *chunk);
+        forEachSpan(overlap, [&](int offset, int length) {
+            total += BlockKernels::countEqual(&blocks[offset], length, block);
+        });
+    });
+
+    return total;
+}
+
+std::optional<WorldPos> RegionQuery::find(const World& world, const BlockBox& box, BlockID block)
+{
+    std::optional<WorldPos> found{};
+    PooledBuffer<BlockID> blocks{};
+
+    forEachChunk(box, [&](ChunkCoord coord, const LocalBox& overlap) {
+        if (found)
+            return;
+
+        const Chunk* chunk{ world.getChunk(coord) };
+        if (!chunk)
+        {
+            if (block == Blocks::air)
+                found = toWorld(coord, overlap.min);
+            return;
+        }
+
+        if (!chunk->getStorage().mayContain(block))
+            return;
+
+        if (chunk->isUniform())
+        {
+            found = toWorld(coord, overlap.min);
+            return;
+        }
+
+        decodeInto(blocks, *chunk);
+        forEachSpan(overlap, [&](int offset, int length) {
+            if (found)
+                return;
+
+            const std::size_t match{ BlockKernels::findEqual(&blocks[offset], length, block) };
+            if (match != static_cast<std::size_t>(length))
+                found = toWorld(coord, VoxelLayout::Linear::position(offset + static_cast<int>(match)));
+        });
+    });
+
+    return found;
+}
+
+bool RegionQuery::isEmpty(const World& world, const BlockBox& box)
+{
+    bool empty{ true };
+
+    forEachChunk(box, [&](ChunkCoord coord, const LocalBox& overlap) {
+        if (!empty)
+            return;
+
+        const Chunk* chunk{ world.getChunk(coord) };
+        if (chunk && !chunk->getOccupancy().isBoxEmpty(overlap))
+            empty = false;
+    });
+
+    return empty;
+}
+
+std::size_t RegionQuery::replace(World& world, const BlockBox& box, BlockID from, BlockID to)
+{
+    if (from == to)
+        return 0;
+
+    std::size_t total{ 0 };
+    PooledBuffer<BlockID> blocks{};
+
+    forEachChunk(box, [&](ChunkCoord coord, const LocalBox& overlap) {
+        Chunk* chunk{ world.getChunk(coord) };
+        if (!chunk)
+        {
+            if (from != Blocks::air)
+                return;
+
+            chunk = &world.getOrCreateChunk(coord);
+        }
+
+        if (!chunk->getStorage().mayContain(from))
+            return;
+
+        if (chunk->isUniform() && coversChunk(overlap))
+        {
+            chunk->fill(to);
+            world.refreshHeightmaps(coord);
+            total += ChunkConstants::volume;
+            return;
+        }
+
+        decodeInto(blocks, *chunk);
+
+        std::size_t replaced{ 0 };
+        forEachSpan(overlap, [&](int offset, int length) {
+            replaced += BlockKernels::replaceEqual(&blocks[offset], length, from, to);
+        });
+
+        // Re-encoding picks the narrowest palette for the new contents
+        if (replaced != 0)
+        {
+            chunk->encodeBlocks(blocks);
+            world.refreshHeightmaps(coord);
+            total += replaced;
+        }
+    });
+
+    return total;
+}
@@ -0,0 +1,99 @@
+#ifndef REGION_QUERY_H
+#define REGION_QUERY_H
+
+#include <cstddef>
+#include <optional>
+
+#include "Block.h"
+#include "Chunk.h"
+#include "ChunkPool.h"
+#include "Coordinates.h"
+#include "World.h"
+
+/*
+    Queries over an axis-aligned box of blocks.
+
+    The box is walked one chunk at a time. Each chunk first tries its uniform flag and palette,
+    which settle most queries without touching a voxel, otherwise it is decoded once and the
+    BlockKernels run over the rows the box covers. Unloaded chunks read as air, as in
+    World::getBlock. Main thread only, like the world's raw chunk accessors.
+*/
+namespace RegionQuery
+{
+    std::size_t count(const World& world, const BlockBox& box, BlockID block);
+
+    // First match with chunks visited in y, z, x order and rows in linear order within a chunk
+    std::optional<WorldPos> find(const World& world, const BlockBox& box, BlockID block);
+
+    // Occupancy test for collision sweeps, answered from the occupancy bitmaps without decoding
+    bool isEmpty(const World& world, const BlockBox& box);
+
+    // Returns how many blocks were replaced, replacing air creates the chunks it lands in
+    std::size_t replace(World& world, const BlockBox& box, BlockID from, BlockID to);
+
+    // fn(ChunkCoord coord, const LocalBox& overlap) for every chunk the box touches
+    template <typename Fn>
+    void forEachChunk(const BlockBox& box, Fn&& fn)
+    {
+        if (box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z)
+            return;
+
+        const ChunkCoord first{ Coordinates::worldToChunk(box.min.x, box.min.y, box.min.z) };
+        const ChunkCoord last{ Coordinates::worldToChunk(box.max.x, box.max.y, box.max.z) };
+
+        for (BlockCoord y{ first.y }; y <= last.y; ++y)
+        {
+            for (BlockCoord z{ first.z }; z <= last.z; ++z)
+            {
+                for (BlockCoord x{ first.x }; x <= last.x; ++x)
+                {
+                    const LocalBox overlap{
+                        { x == first.x ? Coordinates::worldToLocal(box.min.x) : 0,
+                          y == first.y ? Coordinates::worldToLocal(box.min.y) : 0,
+                          z == first.z ? Coordinates::worldToLocal(box.min.z) : 0 },
+                        { x == last.x ? Coordinates::worldToLocal(box.max.x) : ChunkConstants::mask,
+                          y == last.y ? Coordinates::worldToLocal(box.max.y) : ChunkConstants::mask,
+                          z == last.z ? Coordinates::worldToLocal(box.max.z) : ChunkConstants::mask }
+                    };
+
+                    fn(ChunkCoord{ x, y, z }, overlap);
+                }
+            }
+        }
+    }
+
+    // fn(WorldPos position, BlockID block) for every block in the box, chunk by chunk
+    template <typename Fn>
+    void forEachBlock(const World& world, const BlockBox& box, Fn&& fn)
+    {
+        PooledBuffer<BlockID> blocks{ ChunkConstants::volume };
+
+        forEachChunk(box, [&](ChunkCoord coord, const LocalBox& overlap) {
+            const Chunk* chunk{ world.getChunk(coord) };
+
+            // Uniform and missing chunks are answered without decoding
+            const bool decoded{ chunk && !chunk->isUniform() };
+            const BlockID fill{ chunk ? chunk->getUniformBlock() : Blocks::air };
+            if (decoded)
+                chunk->decodeBlocks(blocks);
+
+            for (int y{ overlap.min.y }; y <= overlap.max.y; ++y)
+            {
+                for (int z{ overlap.min.z }; z <= overlap.max.z; ++z)
+                {
+                    for (int x{ overlap.min.x }; x <= overlap.max.x; ++x)
+                    {
+                        const WorldPos position{
+                            Coordinates::chunkToWorld(coord.x, x),
+                            Coordinates::chunkToWorld(coord.y, y),
+                            Coordinates::chunkToWorld(coord.z, z)
+                        };
+                        fn(position, decoded ? blocks[Coordinates::localToIndex(x, y, z)] : fill);
+                    }
+                }
+            }
+        });
+    }
+}
+
+#endif // !REGION_QUERY_H
@@ -0,0 +1,82 @@
+#ifndef VOXEL_LAYOUT_H
+#define VOXEL_LAYOUT_H
+
+#include <array>
+#include <cstdint>
+
+#include "Coordinates.h"
+
+/*
+    Maps local voxel positions to storage indices.
+
+    Linear puts x neighbours next to each other but y and z neighbours a whole row or slice
+    apart. Morton interleaves the coordinate bits so every 2x2x2, 4x4x4, ... block is contiguous,
+    keeping 6 and 26 neighbourhoods within a few cache lines on every axis.
+*/
+namespace VoxelLayout
+{
+    struct Linear
+    {
+        // Recorded by serialized chunks, whose packed indices are in storage order
+        static constexpr std::uint8_t id{ 0 };
+
+        static constexpr int index(int x, int y, int z)
+        {
+            return Coordinates::localToIndex(x, y, z);
+        }
+
+        static constexpr LocalPos position(int index)
+        {
+            return LocalPos{
+                index & ChunkConstants::mask,
+                index >> (2 * ChunkConstants::sizeLog2),
+                (index >> ChunkConstants::sizeLog2) & ChunkConstants::mask
+            };
+        }
+    };
+
+    struct Morton
+    {
+        static constexpr std::uint8_t id{ 1 };
+
+        // Spreads the bits of a local coordinate three bits apart, x lands on bits 0, 3, 6, ...
+        static constexpr std::array<std::uint16_t, ChunkConstants::size> spreadTable{ [] {
+            std::array<std::uint16_t, ChunkConstants::size> table{};
+            for (int value{ 0 }; value < ChunkConstants::size; ++value)
+            {
+                int spread{ 0 };
+                for (int bit{ 0 }; bit < ChunkConstants::sizeLog2; ++bit)
+                    spread |= ((value >> bit) & 1) << (3 * bit);
+                table[value] = static_cast<std::uint16_t>(spread);
+            }
+            return table;
+        }() };
+
+        static constexpr int compact(int spread)
+        {
+            int value{ 0 };
+            for (int bit{ 0 }; bit < ChunkConstants::sizeLog2; ++bit)
+                value |= ((spread >> (3 * bit)) & 1) << bit;
+            return value;
+        }
+
+        static constexpr int index(int x, int y, int z)
+        {
+            return spreadTable[x] | (spreadTable[z] << 1) | (spreadTable[y] << 2);
+        }
+
+        static constexpr LocalPos position(int index)
+        {
+            return LocalPos{ compact(index), compact(index >> 2), compact(index >> 1) };
+        }
+    };
+}
+
+// Storage order used by every chunk. Linear wins every walk in Tools/LayoutBench and lets decode,
+// encode and snapshots copy whole rows; swap to VoxelLayout::Morton to compare access patterns
+using ChunkLayout = VoxelLayout::Linear;
+
+static_assert(ChunkLayout::index(ChunkConstants::mask, ChunkConstants::mask, ChunkConstants::mask) == ChunkConstants::volume - 1);
+static_assert(ChunkLayout::position(ChunkLayout::index(3, 17, 29)).y == 17);
+
+#endif // !VOXEL_LAYOUT_H
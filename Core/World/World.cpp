@@ -0,0 +1,636 @@
+#include "World.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "BlockRegistry.h"
+#include "EpochManager.h"
+
+// === Helper Functions === //
+namespace
+{
+    // Local y of the highest block of the kind in a chunk column below the given local y, -1 if none
+    int highestInColumn(const Chunk& chunk, Heightmaps::Type type, int x, int z, int below)
+    {
+        using OccupancyConstants::Column;
+
+        // Only occupied voxels are looked up, topmost first
+        Column candidates{ chunk.getOccupancy().getColumn(x, z) };
+        if (below < ChunkConstants::size)
+            candidates &= (Column{ 1 } << below) - 1;
+
+        while (candidates != 0)
+        {
+            const int y{ static_cast<int>(std::bit_width(candidates)) - 1 };
+            if (Heightmaps::matches(type, chunk.getBlock(x, y, z)))
+                return y;
+
+            candidates &= ~(Column{ 1 } << y);
+        }
+
+        return -1;
+    }
+}
+
+// === World Class === //
+BlockID World::getBlock(BlockCoord x, BlockCoord y, BlockCoord z) const
+{
+    const Chunk* chunk{ getChunk(Coordinates::worldToChunk(x, y, z)) };
+    if (!chunk)
+        return Blocks::air;
+
+    const LocalPos local{ Coordinates::worldToLocal(x, y, z) };
+    return chunk->getBlock(local.x, local.y, local.z);
+}
+
+void World::setBlock(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block)
+{
+    const ChunkCoord coord{ Coordinates::worldToChunk(x, y, z) };
+    Chunk* chunk{ getChunk(coord) };
+    if (!chunk)
+    {
+        if (block == Blocks::air)
+            return;
+
+        chunk = &getOrCreateChunk(coord);
+    }
+
+    const LocalPos local{ Coordinates::worldToLocal(x, y, z) };
+    chunk->setBlock(local.x, local.y, local.z, block);
+    updateHeightmaps(x, y, z, block);
+}
+
+Chunk* World::getChunk(ChunkCoord coord)
+{
+    return const_cast<Chunk*>(std::as_const(*this).getChunk(coord));
+}
+
+const Chunk* World::getChunk(ChunkCoord coord) const
+{
+    if (!m_cachedChunk || m_cachedCoord != coord)
+    {
+        // The map keeps its own reference, the raw pointer stays valid until removeChunk
+        ChunkHandle chunk{ m_chunks.find(coord) };
+        if (!chunk)
+            chunk = reloadChunk(coord);
+        if (!chunk)
+            return nullptr;
+
+        m_cachedCoord = coord;
+        m_cachedChunk = chunk.get();
+    }
+
+    m_cachedChunk->touch(m_time);
+    return m_cachedChunk;
+}
+
+Chunk& World::getOrCreateChunk(ChunkCoord coord)
+{
+    // An evicted chunk comes back from disk instead of being recreated empty
+    if (Chunk* existing{ getChunk(coord) })
+        return *existing;
+
+    const ChunkHandle chunk{ m_chunks.findOrCreate(coord) };
+
+    m_cachedCoord = coord;
+    m_cachedChunk = chunk.get();
+    m_cachedChunk->touch(m_time);
+    return *m_cachedChunk;
+}
+
+BlockCoord World::getHeight(Heightmaps::Type type, BlockCoord x, BlockCoord z) const
+{
+    const ColumnHeightmap* heightmap{ getHeightmap({ Coordinates::worldToChunk(x), Coordinates::worldToChunk(z) }) };
+    if (!heightmap)
+        return Heightmaps::none;
+
+    return heightmap->get(type, Coordinates::worldToLocal(x), Coordinates::worldToLocal(z));
+}
+
+const ColumnHeightmap* World::getHeightmap(ColumnCoord coord) const
+{
+    auto it{ m_heightmaps.find(coord) };
+    if (it == m_heightmaps.end() && m_store && m_store->containsHeightmap(coord))
+    {
+        if (std::optional<ColumnHeightmap> stored{ m_store->loadHeightmap(coord) })
+            it = m_heightmaps.emplace(coord, *stored).first;
+    }
+
+    return it != m_heightmaps.end() ? &it->second : nullptr;
+}
+
+void World::refreshHeightmaps(ChunkCoord coord)
+{
+    const Chunk* chunk{ getChunk(coord) };
+    const bool hasBlocks{ chunk && !chunk->isEmpty() };
+
+    // A column that never held a block has nothing to lower
+    const ColumnCoord column{ coord.x, coord.z };
+    if (!hasBlocks && !getHeightmap(column))
+        return;
+
+    ColumnHeightmap& heightmap{ heightmapFor(column, coord.y) };
+    if (hasBlocks)
+        heightmap.extendDown(coord.y);
+
+    const BlockCoord bottom{ Coordinates::chunkToWorld(coord.y) };
+    const BlockCoord top{ Coordinates::chunkToWorld(coord.y, ChunkConstants::mask) };
+
+    for (int z{ 0 }; z < ChunkConstants::size; ++z)
+    {
+        for (int x{ 0 }; x < ChunkConstants::size; ++x)
+        {
+            for (int type{ 0 }; type < Heightmaps::count; ++type)
+            {
+                const Heightmaps::Type heightType{ static_cast<Heightmaps::Type>(type) };
+                const BlockCoord height{ heightmap.get(heightType, x, z) };
+
+                // A block above this chunk still tops the column
+                if (height > top)
+                    continue;
+
+                const int local{ hasBlocks ? highestInColumn(*chunk, heightType, x, z, ChunkConstants::size) : -1 };
+                if (local >= 0)
+                    heightmap.set(heightType, x, z, Coordinates::chunkToWorld(coord.y, local));
+                else if (height >= bottom)
+                    heightmap.set(heightType, x, z, findHeightBelow(heightType, Coordinates::chunkToWorld(coord.x, x), bottom, Coordinates::chunkToWorld(coord.z, z), heightmap.getBottomChunk()));
+            }
+        }
+    }
+}
+
+std::optional<RaycastHit> World::raycast(const glm::dvec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+    const float length{ glm::length(direction) };
+    if (length == 0.0f)
+        return std::nullopt;
+
+    const glm::dvec3 rayDir{ glm::dvec3{ direction } / static_cast<double>(length) };
+
+    std::array<BlockCoord, 3> cell{};
+    for (int axis{ 0 }; axis < 3; ++axis)
+        cell[axis] = static_cast<BlockCoord>(std::floor(origin[axis]));
+
+    glm::ivec3 normal{ 0 };
+    double distance{ 0.0 };
+
+    while (true)
+    {
+        const Chunk* chunk{ getChunk(Coordinates::worldToChunk(cell[0], cell[1], cell[2])) };
+
+        // Largest region around the cell known to be empty: the chunk, a brick or just the voxel
+        int regionLog2{ ChunkConstants::sizeLog2 };
+        if (chunk && !chunk->isEmpty())
+        {
+            using OccupancyConstants::brickSizeLog2;
+
+            const LocalPos local{ Coordinates::worldToLocal(cell[0], cell[1], cell[2]) };
+            const ChunkOccupancy& occupancy{ chunk->getOccupancy() };
+            regionLog2 = brickSizeLog2;
+
+            if (occupancy.isBrickOccupied(local.x >> brickSizeLog2, local.y >> brickSizeLog2, local.z >> brickSizeLog2))
+            {
+                if (occupancy.test(local.x, local.y, local.z))
+                    return RaycastHit{ cell[0], cell[1], cell[2], chunk->getBlock(local.x, local.y, local.z), normal, static_cast<float>(distance) };
+
+                regionLog2 = 0;
+            }
+        }
+
+        // Leave the whole region in one step, masking rounds negative coordinates down as well
+        const BlockCoord regionSize{ BlockCoord{ 1 } << regionLog2 };
+        std::array<BlockCoord, 3> regionMin{};
+        int exitAxis{ 0 };
+        double exitDistance{ std::numeric_limits<double>::infinity() };
+        for (int axis{ 0 }; axis < 3; ++axis)
+        {
+            regionMin[axis] = cell[axis] & ~(regionSize - 1);
+            if (rayDir[axis] == 0.0)
+                continue;
+
+            const BlockCoord boundary{ rayDir[axis] > 0.0 ? regionMin[axis] + regionSize : regionMin[axis] };
+            const double t{ (static_cast<double>(boundary) - origin[axis]) / rayDir[axis] };
+            if (t < exitDistance)
+            {
+                exitDistance = t;
+                exitAxis = axis;
+            }
+        }
+
+        if (exitDistance > maxDistance)
+            return std::nullopt;
+
+        // Step into the neighbouring cell, clamping the other axes so rounding can't skip a region
+        const glm::dvec3 exitPoint{ origin + rayDir * exitDistance };
+        for (int axis{ 0 }; axis < 3; ++axis)
+        {
+            if (axis == exitAxis)
+                cell[axis] = rayDir[axis] > 0.0 ? regionMin[axis] + regionSize : regionMin[axis] - 1;
+            else
+                cell[axis] = std::clamp(static_cast<BlockCoord>(std::floor(exitPoint[axis])), regionMin[axis], regionMin[axis] + regionSize - 1);
+        }
+
+        normal = glm::ivec3{ 0 };
+        normal[exitAxis] = rayDir[exitAxis] > 0.0 ? -1 : 1;
+        distance = exitDistance;
+    }
+}
+
+bool World::canSkipMeshing(ChunkCoord coord) const
+{
+    const Chunk* chunk{ getChunk(coord) };
+    if (!chunk || chunk->isEmpty())
+        return true;
+
+    if (!chunk->isUniform())
+        return false;
+
+    constexpr ChunkCoord faceOffsets[]{ { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (const ChunkCoord& offset : faceOffsets)
+    {
+        const Chunk* neighbour{ getChunk({ coord.x + offset.x, coord.y + offset.y, coord.z + offset.z }) };
+        if (!neighbour || !neighbour->isUniform() || !BlockRegistry::isOpaque(neighbour->getUniformBlock()))
+            return false;
+    }
+
+    return true;
+}
+
+void World::removeChunk(ChunkCoord coord)
+{
+    unloadChunk(coord);
+    refreshHeightmaps(coord);
+}
+
+ChunkHandle World::acquireChunk(ChunkCoord coord) const
+{
+    return m_chunks.find(coord);
+}
+
+void World::publishEdits()
+{
+    // Unchanged chunks return after a pointer compare
+    m_chunks.forEach([](const ChunkCoord&, const ChunkHandle& chunk) {
+        chunk->publish();
+    });
+
+    EpochManager::instance().advance();
+}
+
+void World::setTime(double seconds)
+{
+    m_time = seconds;
+}
+
+std::size_t World::compressIdleChunks(double idleSeconds)
+{
+    std::size_t compressed{ 0 };
+    m_chunks.forEach([&](const ChunkCoord&, const ChunkHandle& chunk) {
+        if (chunk->isCompressed() || m_time - chunk->getLastAccess() < idleSeconds)
+            return;
+
+        chunk->compress();
+        if (chunk->isCompressed())
+            ++compressed;
+    });
+
+    return compressed;
+}
+
+ChunkMemoryStats World::getMemoryStats() const
+{
+    ChunkMemoryStats stats{};
+    std::unordered_set<const PaletteStorage*> storages{};
+
+    m_chunks.forEach([&](const ChunkCoord&, const ChunkHandle& chunk) {
+        // Checks the flag first, going through the accessors would decompress
+        if (chunk->isCompressed())
+        {
+            ++stats.compressedChunks;
+            stats.compressedBytes += sizeof(Chunk) + chunk->getCompressedSize();
+            return;
+        }
+
+        ++stats.residentChunks;
+        if (chunk->isStorageShared())
+            ++stats.sharedChunks;
+
+        // The chunk's own share (object and occupancy bitmaps), then its storage once per storage block
+        const PaletteStorage& storage{ chunk->getStorage() };
+        stats.residentBytes += chunk->getMemoryUsage() - storage.getMemoryUsage();
+        if (storages.insert(&storage).second)
+            stats.residentBytes += storage.getMemoryUsage();
+    });
+
+    stats.heightmapColumns = m_heightmaps.size();
+    stats.heightmapBytes = m_heightmaps.size() * sizeof(ColumnHeightmap);
+
+    stats.uniqueStorages = storages.size();
+    if (stats.uniqueStorages != 0)
+        stats.dedupRatio = static_cast<double>(stats.residentChunks) / static_cast<double>(stats.uniqueStorages);
+
+    return stats;
+}
+
+bool World::deduplicateChunk(ChunkCoord coord)
+{
+    const ChunkHandle chunk{ m_chunks.find(coord) };
+
+    // Uniform chunks own no voxel memory and compressed ones would have to be inflated first
+    if (!chunk || chunk->isCompressed() || chunk->isUniform())
+        return false;
+
+    std::weak_ptr<Chunk>& entry{ m_dedupIndex[chunk->getContentHash()] };
+    if (const ChunkHandle indexed{ entry.lock() }; indexed && indexed != chunk)
+    {
+        if (chunk->sharesStorageWith(*indexed))
+            return false;
+
+        // Equal hashes still get a full compare, a collision must never merge different chunks
+        if (chunk->hasSameContent(*indexed))
+        {
+            chunk->shareStorageWith(*indexed);
+            return true;
+        }
+    }
+
+    // First of its kind, or the indexed chunk was edited since, this chunk becomes the reference
+    entry = chunk;
+    return false;
+}
+
+std::size_t World::deduplicateChunks()
+{
+    // Collected up front, deduplicateChunk takes shard locks of its own
+    std::vector<ChunkCoord> coords{};
+    coords.reserve(m_chunks.size());
+    m_chunks.forEach([&](const ChunkCoord& coord, const ChunkHandle&) {
+        coords.push_back(coord);
+    });
+
+    std::erase_if(m_dedupIndex, [](const auto& entry) { return entry.second.expired(); });
+
+    std::size_t merged{ 0 };
+    for (const ChunkCoord& coord : coords)
+    {
+        if (deduplicateChunk(coord))
+            ++merged;
+    }
+
+    return merged;
+}
+
+void World::setChunkStore(const std::filesystem::path& directory)
+{
+    m_store = std::make_unique<ChunkStore>(directory);
+}
+
+void World::setMemoryBudget(std::size_t bytes)
+{
+    m_budget = bytes;
+    m_streamingStats.budgetBytes = bytes;
+}
+
+std::size_t World::enforceMemoryBudget(ChunkCoord focus)
+{
+    const double elapsed{ m_time - m_lastEnforce };
+    m_lastEnforce = m_time;
+
+    const ChunkMemoryStats memory{ getMemoryStats() };
+    std::size_t used{ memory.residentBytes + memory.compressedBytes + memory.heightmapBytes };
+    std::size_t evicted{ 0 };
+
+    if (m_budget != 0 && used > m_budget)
+    {
+        struct Candidate
+        {
+            double score{};
+            ChunkCoord coord{};
+            std::size_t bytes{};
+        };
+
+        std::vector<Candidate> candidates{};
+        candidates.reserve(m_chunks.size());
+        m_chunks.forEach([&](const ChunkCoord& coord, const ChunkHandle& chunk) {
+            // Without a store a modified chunk has nowhere to go
+            if (!m_store && chunk->isModifiedSinceSave())
+                return;
+
+            const double dx{ static_cast<double>(coord.x - focus.x) };
+            const double dy{ static_cast<double>(coord.y - focus.y) };
+            const double dz{ static_cast<double>(coord.z - focus.z) };
+            const double distance{ std::sqrt(dx * dx + dy * dy + dz * dz) };
+            const double idle{ m_time - chunk->getLastAccess() };
+
+            // Shared storage stays alive with the chunks still using it
+            const std::size_t bytes{ chunk->isStorageShared() ? sizeof(Chunk) : chunk->getMemoryUsage() };
+            candidates.push_back({ idle + distance * WorldConstants::evictSecondsPerChunk, coord, bytes });
+        });
+
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.score > b.score;
+        });
+
+        for (const Candidate& candidate : candidates)
+        {
+            if (used <= m_budget)
+                break;
+
+            if (!evictChunk(candidate.coord))
+                continue;
+
+            used -= std::min(used, candidate.bytes);
+            ++evicted;
+        }
+    }
+
+    used -= std::min(used, pruneHeightmaps());
+    m_streamingStats.usedBytes = used;
+
+    // Exponential moving average, so the rate reflects recent pressure rather than the whole session
+    if (elapsed > 0.0)
+    {
+        const double rate{ static_cast<double>(evicted) / elapsed };
+        const double blend{ std::min(1.0, elapsed / WorldConstants::evictionRateWindow) };
+        m_streamingStats.evictionsPerSecond += (rate - m_streamingStats.evictionsPerSecond) * blend;
+    }
+
+    return evicted;
+}
+
+std::size_t World::saveModifiedChunks()
+{
+    if (!m_store)
+        return 0;
+
+    std::size_t saved{ 0 };
+    m_chunks.forEach([&](const ChunkCoord&, const ChunkHandle& chunk) {
+        if (chunk->isModifiedSinceSave() && m_store->save(*chunk))
+        {
+            chunk->markSaved();
+            ++saved;
+        }
+    });
+
+    return saved;
+}
+
+ChunkStreamingStats World::getStreamingStats() const
+{
+    return m_streamingStats;
+}
+
+ChunkHandle World::reloadChunk(ChunkCoord coord) const
+{
+    if (!m_store || !m_store->contains(coord))
+        return nullptr;
+
+    const auto start{ std::chrono::steady_clock::now() };
+
+    ChunkHandle chunk{ makePooled<Chunk>(coord) };
+    if (!m_store->load(*chunk))
+        return nullptr;
+
+    chunk->touch(m_time);
+    m_chunks.insert(coord, chunk);
+
+    const double milliseconds{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() };
+    ChunkStreamingStats& stats{ m_streamingStats };
+    ++stats.reloads;
+    stats.lastReloadMs = milliseconds;
+    stats.averageReloadMs += (milliseconds - stats.averageReloadMs) / static_cast<double>(stats.reloads);
+    stats.maxReloadMs = std::max(stats.maxReloadMs, milliseconds);
+
+    return chunk;
+}
+
+bool World::evictChunk(ChunkCoord coord)
+{
+    const ChunkHandle chunk{ m_chunks.find(coord) };
+    if (!chunk)
+        return false;
+
+    if (chunk->isModifiedSinceSave())
+    {
+        if (!m_store || !m_store->save(*chunk))
+            return false;
+
+        chunk->markSaved();
+        ++m_streamingStats.evictionWrites;
+    }
+
+    unloadChunk(coord);
+    ++m_streamingStats.evictions;
+    return true;
+}
+
+void World::unloadChunk(ChunkCoord coord)
+{
+    if (m_cachedChunk && m_cachedCoord == coord)
+        m_cachedChunk = nullptr;
+
+    m_chunks.erase(coord);
+}
+
+ColumnHeightmap& World::heightmapFor(ColumnCoord coord, BlockCoord chunkY)
+{
+    // Brings a stored heightmap back first, try_emplace only creates one when there is none
+    getHeightmap(coord);
+    return m_heightmaps.try_emplace(coord, Coordinates::chunkToWorld(chunkY)).first->second;
+}
+
+std::size_t World::pruneHeightmaps()
+{
+    std::unordered_set<ColumnCoord, ColumnCoordHash> resident{};
+    m_chunks.forEach([&](const ChunkCoord& coord, const ChunkHandle&) {
+        resident.insert({ coord.x, coord.z });
+    });
+
+    // Without a store the chunks under an unsaved heightmap were unmodified and are gone too
+    std::size_t dropped{ 0 };
+    for (auto it{ m_heightmaps.begin() }; it != m_heightmaps.end();)
+    {
+        const auto& [coord, heightmap]{ *it };
+        const bool keep{ resident.contains(coord)
+            || (m_store && heightmap.isModifiedSinceSave() && !m_store->saveHeightmap(coord, heightmap)) };
+        if (keep)
+        {
+            ++it;
+            continue;
+        }
+
+        it = m_heightmaps.erase(it);
+        ++dropped;
+    }
+
+    return dropped * sizeof(ColumnHeightmap);
+}
+
+void World::updateHeightmaps(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block)
+{
+    const ChunkCoord coord{ Coordinates::worldToChunk(x, y, z) };
+    ColumnHeightmap& heightmap{ heightmapFor({ coord.x, coord.z }, coord.y) };
+    if (Heightmaps::matches(Heightmaps::surface, block))
+        heightmap.extendDown(coord.y);
+
+    const int localX{ Coordinates::worldToLocal(x) };
+    const int localZ{ Coordinates::worldToLocal(z) };
+    for (int type{ 0 }; type < Heightmaps::count; ++type)
+    {
+        const Heightmaps::Type heightType{ static_cast<Heightmaps::Type>(type) };
+        const BlockCoord height{ heightmap.get(heightType, localX, localZ) };
+
+        // Only writing above the top or replacing the top itself changes the height
+        if (Heightmaps::matches(heightType, block))
+        {
+            if (y > height)
+                heightmap.set(heightType, localX, localZ, y);
+        }
+        else if (y == height)
+        {
+            heightmap.set(heightType, localX, localZ, findHeightBelow(heightType, x, y, z, heightmap.getBottomChunk()));
+        }
+    }
+}
+
+BlockCoord World::findHeightBelow(Heightmaps::Type type, BlockCoord x, BlockCoord y, BlockCoord z, BlockCoord bottomChunk) const
+{
+    const BlockCoord chunkX{ Coordinates::worldToChunk(x) };
+    const BlockCoord chunkZ{ Coordinates::worldToChunk(z) };
+    const int localX{ Coordinates::worldToLocal(x) };
+    const int localZ{ Coordinates::worldToLocal(z) };
+
+    // The first chunk is searched below y, every chunk under it whole
+    int below{ Coordinates::worldToLocal(y) };
+    for (BlockCoord chunkY{ Coordinates::worldToChunk(y) }; chunkY >= bottomChunk; --chunkY)
+    {
+        const Chunk* chunk{ getChunk({ chunkX, chunkY, chunkZ }) };
+        if (chunk && !chunk->isEmpty())
+        {
+            const int local{ highestInColumn(*chunk, type, localX, localZ, below) };
+            if (local >= 0)
+                return Coordinates::chunkToWorld(chunkY, local);
+        }
+
+        below = ChunkConstants::size;
+    }
+
+    return Heightmaps::none;
+}
+
+const ConcurrentChunkMap& World::getChunks() const
+{
+    return m_chunks;
+}
+
+std::size_t World::getChunkCount() const
+{
+    return m_chunks.size();
+}
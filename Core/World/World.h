@@ -0,0 +1,216 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "Chunk.h"
+#include "ChunkStore.h"
+#include "ConcurrentChunkMap.h"
+#include "Coordinates.h"
+#include "Heightmap.h"
+#include "Raycast.h"
+
+namespace WorldConstants
+{
+    // Chunks untouched for this long get compressed in memory
+    inline constexpr double compressIdleSeconds{ 30.0 };
+
+    // Eviction weighs each chunk of distance from the focus like this many seconds of idleness
+    inline constexpr double evictSecondsPerChunk{ 2.0 };
+
+    // Time constant for the smoothed eviction rate
+    inline constexpr double evictionRateWindow{ 10.0 };
+}
+
+// Resident bytes are packed voxel storage, compressed bytes are run-length encoded idle chunks
+struct ChunkMemoryStats
+{
+    std::size_t residentChunks{};
+    std::size_t compressedChunks{};
+    std::size_t residentBytes{};
+    std::size_t compressedBytes{};
+
+    // Column heightmaps held in memory, counted against the budget like chunk data
+    std::size_t heightmapColumns{};
+    std::size_t heightmapBytes{};
+
+    // Resident chunks per distinct storage block, shared storage is only counted once in residentBytes
+    std::size_t uniqueStorages{};
+    std::size_t sharedChunks{};
+    double dedupRatio{ 1.0 };
+};
+
+// Memory budget counters, usage is as measured by the last enforceMemoryBudget call
+struct ChunkStreamingStats
+{
+    std::size_t budgetBytes{};
+    std::size_t usedBytes{};
+
+    // Writes count the evicted chunks that had to be saved first
+    std::size_t evictions{};
+    std::size_t evictionWrites{};
+    double evictionsPerSecond{};
+
+    std::size_t reloads{};
+    double lastReloadMs{};
+    double averageReloadMs{};
+    double maxReloadMs{};
+};
+
+/*
+    Chunked voxel world.
+
+    Block and chunk accessors returning raw pointers are for the main thread, which is the only
+    thread that inserts and evicts. Workers take a ChunkHandle through acquireChunk instead and
+    read the chunk's published version under an EpochGuard.
+*/
+class World
+{
+public:
+    World() = default;
+    ~World() = default;
+
+    // Deleted copy and move operations, the world is a single long-lived object
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    World(World&&) = delete;
+    World& operator=(World&&) = delete;
+
+    // Block access using world coordinates, unloaded chunks read as air
+    BlockID getBlock(BlockCoord x, BlockCoord y, BlockCoord z) const;
+
+    // Creates the owning chunk on demand, writing air into an unloaded chunk is a no-op
+    void setBlock(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block);
+
+    // Chunk access, returns nullptr when the chunk is not loaded
+    Chunk* getChunk(ChunkCoord coord);
+    const Chunk* getChunk(ChunkCoord coord) const;
+
+    Chunk& getOrCreateChunk(ChunkCoord coord);
+
+    // Drops the chunk's blocks from the heightmaps as well, unlike eviction
+    void removeChunk(ChunkCoord coord);
+
+    // Thread-safe, the handle keeps the chunk alive even if the main thread evicts it
+    ChunkHandle acquireChunk(ChunkCoord coord) const;
+
+    /*
+        Publishes every chunk edited since the last call and advances the reclamation epoch.
+        Call once per frame after the frame's edits, workers see the world as of the last call.
+    */
+    void publishEdits();
+
+    /*
+        Heightmaps per chunk column, kept up to date by setBlock. Raising a column is O(1), clearing
+        its top block walks the occupancy bits down to the next match, which in terrain is almost
+        always the block right below. Chunks filled or edited without setBlock (generated, loaded
+        from disk, RegionQuery::replace) need refreshHeightmaps afterwards. Columns without a
+        block of the kind read Heightmaps::none.
+    */
+    BlockCoord getHeight(Heightmaps::Type type, BlockCoord x, BlockCoord z) const;
+
+    // For reading many heights of one chunk column, nullptr when nothing was ever placed there.
+    // A column whose chunks were all evicted has its heightmap brought back from the store
+    const ColumnHeightmap* getHeightmap(ColumnCoord coord) const;
+
+    // Recomputes the columns running through one chunk from its current contents
+    void refreshHeightmaps(ChunkCoord coord);
+
+    // DDA through the occupancy bitmaps, empty chunks and 4^3 bricks are crossed in one step, the double origin keeps far rays exact
+    std::optional<RaycastHit> raycast(const glm::dvec3& origin, const glm::vec3& direction, float maxDistance) const;
+
+    /*
+        True when meshing the chunk cannot produce a single face: it is all air, or it is
+        uniform and every face neighbour is loaded and uniformly opaque
+    */
+    bool canSkipMeshing(ChunkCoord coord) const;
+
+    // Clock used to stamp chunk accesses, call once per frame
+    void setTime(double seconds);
+
+    // Compresses every chunk idle for at least idleSeconds and returns how many were compressed
+    std::size_t compressIdleChunks(double idleSeconds = WorldConstants::compressIdleSeconds);
+    ChunkMemoryStats getMemoryStats() const;
+
+    /*
+        Content-hash deduplication: a chunk identical to one already indexed drops its own storage
+        and shares the indexed one copy-on-write. Call deduplicateChunk after generating or loading
+        a chunk, deduplicateChunks for a full pass. Both return how many chunks started sharing.
+    */
+    bool deduplicateChunk(ChunkCoord coord);
+    std::size_t deduplicateChunks();
+
+    /*
+        Memory budget. Once resident chunk data and heightmaps exceed it, chunks are evicted least
+        recently used first, weighted by distance from the focus chunk. Modified chunks are written
+        to the chunk store on the way out, and evicted chunks are reloaded transparently on their
+        next access. Without a store only unmodified chunks can be evicted. Every call also drops
+        the heightmaps of columns left without a resident chunk, saving them to the store first.
+        A budget of 0 means unlimited.
+    */
+    void setChunkStore(const std::filesystem::path& directory);
+    void setMemoryBudget(std::size_t bytes);
+
+    // Call once per frame or less often, returns how many chunks were evicted
+    std::size_t enforceMemoryBudget(ChunkCoord focus);
+
+    // Writes every chunk modified since its last save, before shutdown for instance
+    std::size_t saveModifiedChunks();
+
+    ChunkStreamingStats getStreamingStats() const;
+
+    // The render loop iterates chunks, never individual blocks
+    const ConcurrentChunkMap& getChunks() const;
+    std::size_t getChunkCount() const;
+
+private:
+    // Brings an evicted chunk back from the store, null when it isn't there or fails to load
+    ChunkHandle reloadChunk(ChunkCoord coord) const;
+
+    // Saves the chunk first when modified, fails when it can't be saved
+    bool evictChunk(ChunkCoord coord);
+
+    // Drops the chunk from memory only, shared by removal and eviction
+    void unloadChunk(ChunkCoord coord);
+
+    // The column's heightmap, loaded from the store or created with its base at chunkY when missing
+    ColumnHeightmap& heightmapFor(ColumnCoord coord, BlockCoord chunkY);
+
+    // Drops heightmaps of columns with no resident chunk and returns the bytes freed, one kept in memory when it can't be saved
+    std::size_t pruneHeightmaps();
+
+    // Updates every heightmap of the column after a single block write
+    void updateHeightmaps(BlockCoord x, BlockCoord y, BlockCoord z, BlockID block);
+
+    // Highest block of the kind strictly below world y in the column, searching chunk by chunk
+    BlockCoord findHeightBelow(Heightmaps::Type type, BlockCoord x, BlockCoord y, BlockCoord z, BlockCoord bottomChunk) const;
+
+    // Mutable because reloading an evicted chunk doesn't change what the world contains
+    mutable ConcurrentChunkMap m_chunks{};
+    double m_time{};
+
+    // Columns with a resident chunk, the rest live in the store. Mutable for the same reason as m_chunks
+    mutable std::unordered_map<ColumnCoord, ColumnHeightmap, ColumnCoordHash> m_heightmaps{};
+
+    std::unique_ptr<ChunkStore> m_store{};
+    std::size_t m_budget{ 0 };
+    double m_lastEnforce{};
+    mutable ChunkStreamingStats m_streamingStats{};
+
+    // Last chunk looked up by the main thread, consecutive block accesses mostly hit the same chunk
+    mutable ChunkCoord m_cachedCoord{};
+    mutable Chunk* m_cachedChunk{ nullptr };
+
+    // Content hash to the chunk whose storage others share, weak so eviction isn't held up
+    std::unordered_map<std::uint64_t, std::weak_ptr<Chunk>> m_dedupIndex{};
+};
+
+#endif // !WORLD_H
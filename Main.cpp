@@ -1,7 +1,10 @@
 #include <array>
 #include <cmath>
 #include <iostream>
+#include <memory>
 #include <numbers>
+#include <utility>
+#include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -15,7 +18,11 @@
 #include "Core/Render/Shader.h"
 #include "Core/Render/Texture.h"
 #include "Core/Render/Camera.h"
+#include "Core/Render/ChunkMesh.h"
 #include "Core/System/Gravity.h"
+#include "Core/World/ChunkMesher.h"
+#include "Core/World/ChunkSnapshot.h"
+#include "Core/World/World.h"
 
 // Callback function forward declarations
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -29,6 +36,9 @@ namespace Configs
     inline constexpr int SCR_WIDTH{ 1200 };
     inline constexpr int SCR_HEIGHT{ 900 };
     inline constexpr float ASPECT_RATIO{ static_cast<float>(SCR_WIDTH) / SCR_HEIGHT };
+
+    // Demo terrain spans this many chunks either side of the origin along x and z
+    inline constexpr int TERRAIN_RADIUS{ 2 };
 }
 
 namespace Globals
@@ -48,6 +58,8 @@ namespace Globals
 
     bool g_enableWireframe{ false };
     bool g_enableLightMove{ true };
+    bool g_enableGreedyMeshing{ true };
+    bool g_enableInstancedFaces{ true };
 }
 
 constexpr std::array<GLfloat, 288> vertices
@@ -129,6 +141,53 @@ namespace
 
         return true;
     }
+
+    // Rolling hills in the chunk layer below the camera, grass on dirt on stone
+    void generateTerrain(World& world)
+    {
+        constexpr int size{ ChunkConstants::size };
+        constexpr int extent{ Configs::TERRAIN_RADIUS * size };
+
+        for (int z{ -extent }; z < extent; ++z)
+        {
+            for (int x{ -extent }; x < extent; ++x)
+            {
+                const int height{ static_cast<int>(-6.0f + 3.0f * std::sin(x * 0.15f) + 3.0f * std::cos(z * 0.11f)) };
+                for (int y{ -size }; y <= height; ++y)
+                {
+                    const BlockID block{ y == height ? Blocks::grass : y > height - 3 ? Blocks::dirt : Blocks::stone };
+                    world.setBlock(x, y, z, block);
+                }
+            }
+        }
+    }
+
+    // One mesh per chunk that can show a face, greedy merges coplanar faces of the same block with the binary mesher
+    std::vector<std::pair<ChunkCoord, std::unique_ptr<ChunkMesh>>> buildChunkMeshes(const World& world, bool greedy, bool instanced)
+    {
+        // Coordinates are gathered first, snapshots look chunks up and must not run under the map's locks
+        std::vector<ChunkCoord> coords{};
+        world.getChunks().forEach([&](const ChunkCoord& coord, const ChunkHandle&) { coords.push_back(coord); });
+
+        std::vector<std::pair<ChunkCoord, std::unique_ptr<ChunkMesh>>> meshes{};
+        // Packed vertices are 8 bytes against 32 for floats, a face instance is 8 bytes for all six vertices
+        ChunkMeshData data{ .format = instanced ? MeshConstants::faceInstances : MeshConstants::packedVertices };
+        for (ChunkCoord coord : coords)
+        {
+            if (world.canSkipMeshing(coord))
+                continue;
+
+            const ChunkSnapshot snapshot{ world, coord };
+            if (greedy)
+                ChunkMesher::meshBinary(snapshot, data);
+            else
+                ChunkMesher::meshCulled(snapshot, data);
+            if (data.faceCount != 0)
+                meshes.emplace_back(coord, std::make_unique<ChunkMesh>(data));
+        }
+
+        return meshes;
+    }
 }
 
 int main()
@@ -164,20 +223,19 @@ int main()
     glViewport(0, 0, Configs::SCR_WIDTH, Configs::SCR_HEIGHT);
 
     // Creates shader program
-    Shader lightingShader("Shaders/lightingVert.glsl", "Shaders/lightingFrag.glsl");
+    Shader lightingShader("Shaders/chunkVert.glsl", "Shaders/lightingFrag.glsl");
+    Shader instancedShader("Shaders/chunkInstanceVert.glsl", "Shaders/lightingFrag.glsl");
     Shader lightCubeShader("Shaders/lightCubeVert.glsl", "Shaders/lightCubeFrag.glsl");
 
-    // Initialize cube's VAO and VBO
-    VAO cubeVao{};
-    cubeVao.Bind();
+    // Terrain is meshed per chunk, only faces that can be seen reach the GPU
+    World world{};
+    generateTerrain(world);
+    bool meshedGreedy{ Globals::g_enableGreedyMeshing };
+    bool meshedInstanced{ Globals::g_enableInstancedFaces };
+    auto chunkMeshes{ buildChunkMeshes(world, meshedGreedy, meshedInstanced) };
 
-    VBO cubeVbo{ vertices, GL_STATIC_DRAW };
-    cubeVbo.Bind();
-    cubeVao.LinkAttrib(cubeVbo, 0, 3, GL_FLOAT, 8 * sizeof(GLfloat), 0);                    // Position
-    cubeVao.LinkAttrib(cubeVbo, 1, 3, GL_FLOAT, 8 * sizeof(GLfloat), 3 * sizeof(GLfloat));  // Normal
-    cubeVao.LinkAttrib(cubeVbo, 2, 2, GL_FLOAT, 8 * sizeof(GLfloat), 6 * sizeof(GLfloat));  // Texture Coord
-    
     // Initialize light source's VAO and VBO
+    VBO cubeVbo{ vertices, GL_STATIC_DRAW };
     VAO lightVAO{};
     lightVAO.Bind();
     
@@ -192,8 +250,11 @@ int main()
     lightingShader.SetInt("material.diffuse", 0);
     lightingShader.SetInt("material.specular", 1);
 
+    instancedShader.Use();
+    instancedShader.SetInt("material.diffuse", 0);
+    instancedShader.SetInt("material.specular", 1);
+
     // Unbind to prevent accidental modifications
-    cubeVao.Unbind();
     lightVAO.Unbind();
     cubeVbo.Unbind();
 
@@ -231,6 +292,14 @@ int main()
         // Input
         processInput(window);
 
+        // Remesh when the meshing mode or vertex format was switched
+        if (meshedGreedy != Globals::g_enableGreedyMeshing || meshedInstanced != Globals::g_enableInstancedFaces)
+        {
+            meshedGreedy = Globals::g_enableGreedyMeshing;
+            meshedInstanced = Globals::g_enableInstancedFaces;
+            chunkMeshes = buildChunkMeshes(world, meshedGreedy, meshedInstanced);
+        }
+
         // Render
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -248,42 +317,47 @@ int main()
             Globals::g_lastLightPos = lightPos;
         }
 
-        // Activate shader and set uniforms
-        lightingShader.Use();
-        lightingShader.SetVec3("light.position", lightPos);
-        lightingShader.SetVec3("viewPos", Globals::g_camera.m_cameraPosition);
+        // Everything is positioned relative to the camera, which makes the camera itself the origin
+        const ChunkCoord originChunk{};
+        const glm::vec3 relativeLightPos{ Globals::g_camera.GetRelativePosition(originChunk, lightPos) };
+
+        // Activate shader and set uniforms, the instanced path has its own vertex shader
+        Shader& terrainShader{ meshedInstanced ? instancedShader : lightingShader };
+        terrainShader.Use();
+        terrainShader.SetVec3("light.position", relativeLightPos);
+        terrainShader.SetVec3("viewPos", glm::vec3{ 0.0f });
 
         // Set light intensity
         const glm::vec3 diffuseColor{ lightColor * glm::vec3{ 0.5f } };
         const glm::vec3 ambientColor{ diffuseColor * glm::vec3{ 0.2f } };
-        lightingShader.SetVec3("light.ambient", ambientColor);
-        lightingShader.SetVec3("light.diffuse", diffuseColor);
-        lightingShader.SetVec3("light.specular", glm::vec3{ 1.0f });
+        terrainShader.SetVec3("light.ambient", ambientColor);
+        terrainShader.SetVec3("light.diffuse", diffuseColor);
+        terrainShader.SetVec3("light.specular", glm::vec3{ 1.0f });
 
         // Set material quality
-        lightingShader.SetVec3("material.specular", glm::vec3{ 0.5f });
-        lightingShader.SetFloat("material.shininess", 64.0f);
+        terrainShader.SetVec3("material.specular", glm::vec3{ 0.5f });
+        terrainShader.SetFloat("material.shininess", 64.0f);
 
         // View/projection matrix transformations
         constexpr float nearPlane{ 0.1f };
         constexpr float farPlane{ 100.0f };
         const glm::mat4 proj{ glm::perspective(glm::radians(Globals::g_camera.m_zoom), Configs::ASPECT_RATIO, nearPlane, farPlane) };
         const glm::mat4 view{ Globals::g_camera.GetViewMatrix() };
-        lightingShader.SetMat4("proj", proj);
-        lightingShader.SetMat4("view", view);
-
-        // World transformation
-        glm::mat4 model{ glm::mat4{1.0f} };
-        model = glm::translate(model, glm::vec3{ 0.0f, -0.75f, 0.0f });
-        lightingShader.SetMat4("model", model);
+        terrainShader.SetMat4("proj", proj);
+        terrainShader.SetMat4("view", view);
 
         // Bind texture
         container.Bind();
         containerSpec.Bind();
 
-        // Render the cube
-        cubeVao.Bind();
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        // Render the terrain, each mesh is placed at its chunk's corner
+        glm::mat4 model{};
+        for (const auto& [coord, mesh] : chunkMeshes)
+        {
+            model = glm::translate(glm::mat4{ 1.0f }, Globals::g_camera.GetRelativePosition(coord));
+            terrainShader.SetMat4("model", model);
+            mesh->Draw();
+        }
 
         // Render the light source as well
         lightCubeShader.Use();
@@ -292,7 +366,7 @@ int main()
         lightCubeShader.SetMat4("view", view);
 
         model = glm::mat4{ 1.0f };
-        model = glm::translate(model, lightPos);
+        model = glm::translate(model, relativeLightPos);
         model = glm::scale(model, glm::vec3{ 0.2f });
         
         lightCubeShader.SetMat4("model", model);
@@ -378,4 +452,8 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     {
         Globals::g_gravity.toggle();
     }
+    if (key == GLFW_KEY_M && action == GLFW_PRESS)
+        Globals::g_enableGreedyMeshing = !Globals::g_enableGreedyMeshing;
+    if (key == GLFW_KEY_I && action == GLFW_PRESS)
+        Globals::g_enableInstancedFaces = !Globals::g_enableInstancedFaces;
 }
\ No newline at end of file
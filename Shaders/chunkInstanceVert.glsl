@@ -0,0 +1,57 @@
+#version 330 core
+layout (location = 0) in uint aFace;  // Per instance, see PackedFace in ChunkMesher.h
+layout (location = 1) in uint aBlock; // Block id, unused until blocks get their own texture layers
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 proj;
+
+// Indexed by face: +x, -x, +y, -y, +z, -z, matching Faces::Face
+const vec3 normals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0)
+);
+
+// Face geometry matching the mesher's face table: normal axis, side, and the two texture axes
+const int axes[6] = int[6](0, 0, 1, 1, 2, 2);
+const int sides[6] = int[6](1, 0, 1, 0, 1, 0);
+const int uAxes[6] = int[6](2, 2, 0, 0, 0, 0);
+const int vAxes[6] = int[6](1, 1, 2, 2, 1, 1);
+
+// Quad corners as (u, v) per face, four each, wound counter-clockwise seen from outside
+const vec2 corners[24] = vec2[24](
+    vec2(0, 0), vec2(0, 1), vec2(1, 1), vec2(1, 0),
+    vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1),
+    vec2(0, 0), vec2(0, 1), vec2(1, 1), vec2(1, 0),
+    vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1),
+    vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1),
+    vec2(0, 0), vec2(0, 1), vec2(1, 1), vec2(1, 0)
+);
+
+// Two triangles sharing the first and third corner
+const int triangleCorners[6] = int[6](0, 1, 2, 0, 2, 3);
+
+void main()
+{
+    vec3 position = vec3(aFace & 31u, (aFace >> 5) & 31u, (aFace >> 10) & 31u);
+    int face = int((aFace >> 15) & 7u);
+    vec2 size = vec2(((aFace >> 18) & 31u) + 1u, ((aFace >> 23) & 31u) + 1u);
+
+    // Every instance runs vertices 0 to 5, which pick the corner of this face's quad
+    vec2 corner = corners[face * 4 + triangleCorners[gl_VertexID]] * size;
+    position[axes[face]] += float(sides[face]);
+    position[uAxes[face]] += corner.x;
+    position[vAxes[face]] += corner.y;
+
+    // The model matrix only translates, so normals need no correction
+    FragPos = vec3(model * vec4(position, 1.0));
+    Normal = normals[face];
+    TexCoord = corner;
+
+    gl_Position = proj * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,38 @@
+#version 330 core
+layout (location = 0) in uint aPacked;
+layout (location = 1) in uint aBlock; // Block id, unused until blocks get their own texture layers
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 proj;
+
+// Indexed by face: +x, -x, +y, -y, +z, -z, matching Faces::Face
+const vec3 normals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0)
+);
+
+// Texture axes per face, v runs along y on the side faces so textures stay upright
+const int uAxes[6] = int[6](2, 2, 0, 0, 0, 0);
+const int vAxes[6] = int[6](1, 1, 2, 2, 1, 1);
+
+void main()
+{
+    // 6 bits per axis, then the face id, see PackedVertex in ChunkMesher.h
+    vec3 position = vec3(aPacked & 63u, (aPacked >> 6) & 63u, (aPacked >> 12) & 63u);
+    int face = int((aPacked >> 18) & 7u);
+
+    // The model matrix only translates, so normals need no correction
+    FragPos = vec3(model * vec4(position, 1.0));
+    Normal = normals[face];
+
+    // Coordinates counted in blocks, GL_REPEAT tiles the texture once per voxel on merged quads too
+    TexCoord = vec2(position[uAxes[face]], position[vAxes[face]]);
+
+    gl_Position = proj * view * vec4(FragPos, 1.0);
+}
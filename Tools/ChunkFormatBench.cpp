@@ -0,0 +1,193 @@
+// Chunk format benchmark, round-trips uniform, paletted, direct and block entity chunks through
+// ChunkFormat and times both directions. Run it from an optimised build: ChunkFormatBench [repeats]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../Core/World/Block.h"
+#include "../Core/World/BlockRegistry.h"
+#include "../Core/World/Chunk.h"
+#include "../Core/World/ChunkFormat.h"
+#include "../Core/World/PaletteStorage.h"
+
+namespace
+{
+    // Kept outside the timed loops so the compiler can't drop the work
+    volatile std::uint64_t g_sink{};
+
+    struct Case
+    {
+        std::string name{};
+        std::unique_ptr<Chunk> chunk{};
+    };
+
+    // Rolling terrain with scattered glass and water, a surface chunk like the store mostly sees
+    BlockID terrainBlock(int x, int y, int z)
+    {
+        const int height{ 16 + static_cast<int>(6.0 * std::sin(x * 0.3) + 6.0 * std::cos(z * 0.2)) };
+        if (y > height)
+            return y < 14 ? Blocks::water : Blocks::air;
+        if ((x * 7 + y * 13 + z * 5) % 29 == 0)
+            return Blocks::glass;
+
+        return y == height ? Blocks::grass : y > height - 3 ? Blocks::dirt : Blocks::stone;
+    }
+
+    std::unique_ptr<Chunk> uniformChunk()
+    {
+        auto chunk{ std::make_unique<Chunk>(ChunkCoord{ 0, -1, 0 }) };
+        chunk->fill(Blocks::stone);
+        return chunk;
+    }
+
+    std::unique_ptr<Chunk> palettedChunk()
+    {
+        auto chunk{ std::make_unique<Chunk>(ChunkCoord{ 1, 0, 0 }) };
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                    chunk->setBlock(x, y, z, terrainBlock(x, y, z));
+
+        return chunk;
+    }
+
+    /*
+        Every voxel cycles through the registry in 16-bit storage. Going direct on its own takes more
+        than 256 distinct ids, more than the registry holds, so the words are assigned directly.
+    */
+    std::unique_ptr<Chunk> directChunk()
+    {
+        std::vector<std::uint64_t> words(static_cast<std::size_t>(ChunkConstants::volume) * PaletteConstants::directBits / 64);
+        for (int index{ 0 }; index < ChunkConstants::volume; ++index)
+        {
+            const auto block{ static_cast<std::uint64_t>((index + index / 37) % BlockRegistry::count) };
+            words[index / 4] |= block << (index % 4 * PaletteConstants::directBits);
+        }
+
+        PaletteStorage storage{};
+        storage.assign(PaletteConstants::directBits, Blocks::air, {}, {}, words);
+
+        auto chunk{ std::make_unique<Chunk>(ChunkCoord{ 2, 0, 0 }) };
+        chunk->assignStorage(std::move(storage));
+        return chunk;
+    }
+
+    // Terrain with a few hundred entities of varying size, containers and signs on the surface
+    std::unique_ptr<Chunk> blockEntityChunk()
+    {
+        std::unique_ptr<Chunk> chunk{ palettedChunk() };
+        for (int i{ 0 }; i < 400; ++i)
+        {
+            const int x{ (i * 7) % ChunkConstants::size };
+            const int y{ (i * 13) % ChunkConstants::size };
+            const int z{ (i * 5 + i / 32) % ChunkConstants::size };
+            if (chunk->getBlock(x, y, z) != Blocks::air)
+                chunk->setBlockEntity(x, y, z, std::vector<std::uint8_t>(static_cast<std::size_t>(8 + i % 56), static_cast<std::uint8_t>(i)));
+        }
+
+        return chunk;
+    }
+
+    // Every voxel read back through the loaded chunk and in place through the view, plus the entities
+    bool sameChunk(const Chunk& a, const Chunk& b, const ChunkView& view)
+    {
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+        {
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+            {
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                {
+                    if (a.getBlock(x, y, z) != b.getBlock(x, y, z) || a.getBlock(x, y, z) != view.getBlock(x, y, z))
+                        return false;
+                }
+            }
+        }
+
+        bool same{ a.getBlockEntities().size() == b.getBlockEntities().size() };
+        a.getBlockEntities().forEachSorted([&](int index, const BlockEntity& entity) {
+            const BlockEntity* other{ b.getBlockEntities().find(index) };
+            same = same && other && other->block == entity.block && other->data == entity.data;
+        });
+
+        return same;
+    }
+
+    // What the store does on a reload: open the view over the bytes, then copy the sections in
+    bool deserialize(const std::vector<std::byte>& bytes, Chunk& chunk)
+    {
+        const std::optional<ChunkView> view{ ChunkView::open(bytes) };
+        return view && ChunkFormat::load(*view, chunk);
+    }
+
+    // Chunks per second, best of repeats batches
+    template <typename Fn>
+    double timeRate(int repeats, Fn&& fn)
+    {
+        constexpr int batch{ 64 };
+
+        double best{ 1e30 };
+        for (int i{ 0 }; i < repeats; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            for (int j{ 0 }; j < batch; ++j)
+                g_sink = g_sink + fn();
+            const double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+            best = std::min(best, elapsed);
+        }
+
+        return batch / best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int repeats{ argc > 1 ? std::max(1, std::atoi(argv[1])) : 50 };
+
+    std::vector<Case> cases{};
+    cases.push_back({ "uniform", uniformChunk() });
+    cases.push_back({ "paletted", palettedChunk() });
+    cases.push_back({ "direct", directChunk() });
+    cases.push_back({ "block entities", blockEntityChunk() });
+
+    std::cout << std::fixed << std::setprecision(0) << "Chunks per second, best of " << repeats << " batches\n";
+    for (const Case& test : cases)
+    {
+        // The round trip has to be exact before its timings mean anything. The engine keeps no light
+        // per chunk yet, so its section has to come back empty rather than holding stray bytes
+        const std::vector<std::byte> bytes{ ChunkFormat::serialize(*test.chunk) };
+        const std::optional<ChunkView> view{ ChunkView::open(bytes) };
+        Chunk loaded{ test.chunk->getCoord() };
+        if (!view || !ChunkFormat::load(*view, loaded) || !view->getLight().empty() || view->getBitsPerEntry() != test.chunk->getStorage().getBitsPerEntry()
+            || !sameChunk(*test.chunk, loaded, *view))
+        {
+            std::cout << test.name << ": round trip doesn't match the original\n";
+            return -1;
+        }
+
+        const double serializeRate{ timeRate(repeats, [&] { return ChunkFormat::serialize(*test.chunk).size(); }) };
+        Chunk timed{ test.chunk->getCoord() };
+        const double deserializeRate{ timeRate(repeats, [&] { return static_cast<std::size_t>(deserialize(bytes, timed)); }) };
+
+        // And the chunk the timed loads left behind has to match too
+        if (!sameChunk(*test.chunk, timed, *view))
+        {
+            std::cout << test.name << ": timed load doesn't match the original\n";
+            return -1;
+        }
+
+        std::cout << test.name << " (" << bytes.size() << " bytes, " << test.chunk->getStorage().getBitsPerEntry() << " bits): serialize "
+                  << serializeRate << ", deserialize " << deserializeRate << '\n';
+    }
+
+    return 0;
+}
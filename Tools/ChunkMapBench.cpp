@@ -0,0 +1,158 @@
+// Chunk map contention benchmark, times lookups and edits from 1 to 32 threads against the sharded
+// map and against one map behind a single lock. Run it from an optimised build: ChunkMapBench [milliseconds]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../Core/World/Chunk.h"
+#include "../Core/World/ConcurrentChunkMap.h"
+
+namespace
+{
+    // A 32 x 4 x 32 chunk area stays loaded, about what a render distance of 16 keeps
+    constexpr int loadedWidth{ 32 };
+    constexpr int loadedHeight{ 4 };
+
+    // One in this many operations evicts and reloads a chunk, the rest are lookups
+    constexpr std::uint32_t editEvery{ 32 };
+
+    // Kept outside the timed loops so the compiler can't drop the lookups
+    std::atomic<std::uint64_t> g_sink{};
+
+    // The baseline, what World used before the shards: one map behind one shared_mutex
+    class SingleLockMap
+    {
+    public:
+        ChunkHandle find(ChunkCoord coord) const
+        {
+            std::shared_lock lock{ m_mutex };
+            auto it{ m_chunks.find(coord) };
+            return it != m_chunks.end() ? it->second : ChunkHandle{};
+        }
+
+        void insert(ChunkCoord coord, ChunkHandle chunk)
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_chunks.insert_or_assign(coord, std::move(chunk));
+        }
+
+        ChunkHandle erase(ChunkCoord coord)
+        {
+            std::scoped_lock lock{ m_mutex };
+            auto it{ m_chunks.find(coord) };
+            if (it == m_chunks.end())
+                return {};
+
+            ChunkHandle chunk{ std::move(it->second) };
+            m_chunks.erase(it);
+            return chunk;
+        }
+
+    private:
+        mutable std::shared_mutex m_mutex{};
+        std::unordered_map<ChunkCoord, ChunkHandle, ChunkCoordHash> m_chunks{};
+    };
+
+    ChunkCoord randomCoord(std::mt19937& random)
+    {
+        return ChunkCoord{ static_cast<BlockCoord>(random() % loadedWidth), static_cast<BlockCoord>(random() % loadedHeight), static_cast<BlockCoord>(random() % loadedWidth) };
+    }
+
+    template <typename Map>
+    void load(Map& map)
+    {
+        for (int y{ 0 }; y < loadedHeight; ++y)
+            for (int z{ 0 }; z < loadedWidth; ++z)
+                for (int x{ 0 }; x < loadedWidth; ++x)
+                    map.insert({ x, y, z }, std::make_shared<Chunk>(ChunkCoord{ x, y, z }));
+    }
+
+    // Operations per second across all threads, each thread runs until the deadline
+    template <typename Map>
+    double run(Map& map, int threads, std::chrono::milliseconds duration)
+    {
+        std::atomic<bool> start{ false };
+        std::atomic<bool> stop{ false };
+        std::atomic<std::uint64_t> total{ 0 };
+
+        std::vector<std::thread> workers{};
+        for (int t{ 0 }; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                std::mt19937 random{ static_cast<std::uint32_t>(t * 7919 + 1) };
+                std::uint64_t operations{ 0 };
+                std::uint64_t found{ 0 };
+
+                while (!start.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (int i{ 0 }; i < 256; ++i)
+                    {
+                        const ChunkCoord coord{ randomCoord(random) };
+                        if (random() % editEvery == 0)
+                        {
+                            ChunkHandle evicted{ map.erase(coord) };
+                            map.insert(coord, evicted ? std::move(evicted) : std::make_shared<Chunk>(coord));
+                        }
+                        else
+                        {
+                            found += static_cast<bool>(map.find(coord));
+                        }
+                    }
+                    operations += 256;
+                }
+
+                total += operations;
+                g_sink += found;
+            });
+        }
+
+        const auto begin{ std::chrono::steady_clock::now() };
+        start.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(duration);
+        stop.store(true);
+        for (std::thread& worker : workers)
+            worker.join();
+
+        const double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() };
+        return static_cast<double>(total.load()) / seconds;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::chrono::milliseconds duration{ argc > 1 ? std::max(10, std::atoi(argv[1])) : 300 };
+
+    ConcurrentChunkMap sharded{};
+    SingleLockMap single{};
+    load(sharded);
+    load(single);
+
+    std::cout << "Million operations per second, 1 in " << editEvery << " an evict and reload, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+
+    const double shardedBase{ run(sharded, 1, duration) };
+    const double singleBase{ run(single, 1, duration) };
+    for (int threads{ 1 }; threads <= 32; threads *= 2)
+    {
+        const double shardedRate{ threads == 1 ? shardedBase : run(sharded, threads, duration) };
+        const double singleRate{ threads == 1 ? singleBase : run(single, threads, duration) };
+        std::cout << threads << " threads: sharded " << shardedRate / 1e6 << " (" << shardedRate / shardedBase << "x), single lock "
+                  << singleRate / 1e6 << " (" << singleRate / singleBase << "x)\n";
+    }
+
+    return 0;
+}
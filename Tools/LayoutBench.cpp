@@ -0,0 +1,167 @@
+// Voxel layout benchmark, times the same chunk walks over linear and Morton storage.
+// Run it from an optimised build: LayoutBench [repeats]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../Core/World/Block.h"
+#include "../Core/World/BlockRegistry.h"
+#include "../Core/World/Coordinates.h"
+#include "../Core/World/VoxelLayout.h"
+
+namespace
+{
+    // Kept outside the timed loops so the compiler can't drop the work
+    volatile std::uint64_t g_sink{};
+
+    // Rolling terrain with scattered glass and water, a surface chunk like the mesher sees
+    BlockID terrainBlock(int x, int y, int z)
+    {
+        const int height{ 16 + static_cast<int>(6.0 * std::sin(x * 0.3) + 6.0 * std::cos(z * 0.2)) };
+        if (y > height)
+            return y < 14 ? Blocks::water : Blocks::air;
+        if ((x * 7 + y * 13 + z * 5) % 29 == 0)
+            return Blocks::glass;
+
+        return y == height ? Blocks::grass : y > height - 3 ? Blocks::dirt : Blocks::stone;
+    }
+
+    template <typename Layout>
+    std::vector<BlockID> buildChunk()
+    {
+        std::vector<BlockID> blocks(ChunkConstants::volume);
+        for (int y{ 0 }; y < ChunkConstants::size; ++y)
+            for (int z{ 0 }; z < ChunkConstants::size; ++z)
+                for (int x{ 0 }; x < ChunkConstants::size; ++x)
+                    blocks[Layout::index(x, y, z)] = terrainBlock(x, y, z);
+
+        return blocks;
+    }
+
+    // What ChunkIterators::forEachNeighbourhood does: storage order, six neighbours per voxel
+    template <typename Layout>
+    std::uint64_t neighbourhoodWalk(const std::vector<BlockID>& blocks)
+    {
+        std::uint64_t visible{ 0 };
+        for (int index{ 0 }; index < ChunkConstants::volume; ++index)
+        {
+            const LocalPos pos{ Layout::position(index) };
+            const BlockID block{ blocks[index] };
+            for (const LocalPos& offset : Faces::offsets)
+            {
+                const int x{ pos.x + offset.x };
+                const int y{ pos.y + offset.y };
+                const int z{ pos.z + offset.z };
+                const bool inside{ static_cast<unsigned>(x | y | z) < static_cast<unsigned>(ChunkConstants::size) };
+                const BlockID neighbour{ inside ? blocks[Layout::index(x, y, z)] : Blocks::air };
+                visible += block != Blocks::air && !BlockRegistry::isOpaque(neighbour);
+            }
+        }
+
+        return visible;
+    }
+
+    // Nested loops with the given axis innermost, the order a caller indexing by position picks
+    template <typename Layout>
+    std::uint64_t axisSweep(const std::vector<BlockID>& blocks, int innerAxis)
+    {
+        std::uint64_t sum{ 0 };
+        for (int a{ 0 }; a < ChunkConstants::size; ++a)
+        {
+            for (int b{ 0 }; b < ChunkConstants::size; ++b)
+            {
+                for (int c{ 0 }; c < ChunkConstants::size; ++c)
+                {
+                    const int index{ innerAxis == 0 ? Layout::index(c, a, b) : innerAxis == 1 ? Layout::index(a, c, b) : Layout::index(a, b, c) };
+                    sum += blocks[index];
+                }
+            }
+        }
+
+        return sum;
+    }
+
+    // 3x3x3 box sums around every voxel, the access pattern of smoothing and ambient occlusion
+    template <typename Layout>
+    std::uint64_t boxWalk(const std::vector<BlockID>& blocks)
+    {
+        std::uint64_t solid{ 0 };
+        for (int index{ 0 }; index < ChunkConstants::volume; ++index)
+        {
+            const LocalPos pos{ Layout::position(index) };
+            for (int dy{ -1 }; dy <= 1; ++dy)
+                for (int dz{ -1 }; dz <= 1; ++dz)
+                    for (int dx{ -1 }; dx <= 1; ++dx)
+                    {
+                        const int x{ pos.x + dx };
+                        const int y{ pos.y + dy };
+                        const int z{ pos.z + dz };
+                        if (static_cast<unsigned>(x | y | z) < static_cast<unsigned>(ChunkConstants::size))
+                            solid += BlockRegistry::isSolid(blocks[Layout::index(x, y, z)]);
+                    }
+        }
+
+        return solid;
+    }
+
+    // Best of repeats, in nanoseconds per voxel
+    template <typename Fn>
+    double timeWalk(int repeats, Fn&& fn)
+    {
+        double best{ 1e30 };
+        for (int i{ 0 }; i < repeats; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            g_sink = g_sink + fn();
+            const double elapsed{ std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() };
+            best = std::min(best, elapsed);
+        }
+
+        return best / ChunkConstants::volume;
+    }
+
+    template <typename Layout>
+    std::array<double, 5> runLayout(int repeats)
+    {
+        const std::vector<BlockID> blocks{ buildChunk<Layout>() };
+        return {
+            timeWalk(repeats, [&] { return neighbourhoodWalk<Layout>(blocks); }),
+            timeWalk(repeats, [&] { return boxWalk<Layout>(blocks); }),
+            timeWalk(repeats, [&] { return axisSweep<Layout>(blocks, 0); }),
+            timeWalk(repeats, [&] { return axisSweep<Layout>(blocks, 1); }),
+            timeWalk(repeats, [&] { return axisSweep<Layout>(blocks, 2); }),
+        };
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int repeats{ argc > 1 ? std::max(1, std::atoi(argv[1])) : 200 };
+
+    // Both layouts have to agree on the walks before their timings mean anything
+    if (neighbourhoodWalk<VoxelLayout::Linear>(buildChunk<VoxelLayout::Linear>()) != neighbourhoodWalk<VoxelLayout::Morton>(buildChunk<VoxelLayout::Morton>())
+        || boxWalk<VoxelLayout::Linear>(buildChunk<VoxelLayout::Linear>()) != boxWalk<VoxelLayout::Morton>(buildChunk<VoxelLayout::Morton>()))
+    {
+        std::cout << "Layouts disagree on the walk results\n";
+        return -1;
+    }
+
+    const char* names[]{ "6-neighbourhood", "3x3x3 box", "sweep x inner", "sweep y inner", "sweep z inner" };
+    const std::array<double, 5> linear{ runLayout<VoxelLayout::Linear>(repeats) };
+    const std::array<double, 5> morton{ runLayout<VoxelLayout::Morton>(repeats) };
+
+    std::cout << "ns per voxel, best of " << repeats << " runs over one 32^3 chunk\n";
+    for (std::size_t i{ 0 }; i < linear.size(); ++i)
+    {
+        std::cout << names[i] << ": linear " << linear[i] << ", morton " << morton[i]
+                  << " (" << linear[i] / morton[i] << "x)\n";
+    }
+
+    return 0;
+}
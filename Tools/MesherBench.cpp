@@ -0,0 +1,136 @@
+// Chunk mesher benchmark, times meshCulled, meshGreedy and meshBinary on the same snapshots.
+// Run it from an optimised build: MesherBench [repeats]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "../Core/World/Block.h"
+#include "../Core/World/ChunkMesher.h"
+#include "../Core/World/ChunkSnapshot.h"
+#include "../Core/World/World.h"
+
+namespace
+{
+    // Kept outside the timed loops so the compiler can't drop the work
+    volatile std::uint64_t g_sink{};
+
+    enum Terrain
+    {
+        flat,
+        rolling,
+        caves,
+        noisy,
+        sparse,
+        buried,
+        terrainCount,
+    };
+
+    // Chunk (0, 0, 0) and a ring of neighbours around it, so the apron isn't all air
+    void generate(World& world, Terrain terrain)
+    {
+        std::mt19937 random{ 23 };
+        for (int z{ -1 }; z <= ChunkConstants::size; ++z)
+        {
+            for (int x{ -1 }; x <= ChunkConstants::size; ++x)
+            {
+                const int height{ terrain == flat ? 10
+                    : terrain == buried ? ChunkConstants::size
+                    : 14 + static_cast<int>(6.0 * std::sin(x * 0.3) + 6.0 * std::cos(z * 0.2)) };
+
+                for (int y{ -1 }; y <= ChunkConstants::size; ++y)
+                {
+                    BlockID block{ y > height ? Blocks::air : y == height ? Blocks::grass : y > height - 3 ? Blocks::dirt : Blocks::stone };
+                    // Rolling terrain with winding tunnels carved through it
+                    if (terrain == caves && block != Blocks::air && y < height - 2
+                        && std::sin(x * 0.4) * std::cos(y * 0.35) + std::sin(z * 0.3) > 0.4)
+                        block = Blocks::air;
+                    else if (terrain == noisy)
+                        block = random() % 3 == 0 ? Blocks::air : static_cast<BlockID>(1 + random() % 6);
+                    else if (terrain == sparse)
+                        block = random() % 64 == 0 ? Blocks::stone : Blocks::air;
+
+                    if (block != Blocks::air)
+                        world.setBlock(x, y, z, block);
+                }
+            }
+        }
+    }
+
+    // Best of repeats, in microseconds per chunk
+    template <typename Fn>
+    double timeMesher(int repeats, Fn&& fn)
+    {
+        constexpr int batch{ 32 };
+
+        double best{ 1e30 };
+        for (int i{ 0 }; i < repeats; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            for (int j{ 0 }; j < batch; ++j)
+                g_sink = g_sink + fn();
+            const double elapsed{ std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() };
+            best = std::min(best, elapsed);
+        }
+
+        return best / batch;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int repeats{ argc > 1 ? std::max(1, std::atoi(argv[1])) : 30 };
+
+    const char* names[]{ "flat", "rolling", "caves", "noisy", "sparse", "buried" };
+    const char* mesherNames[]{ "culled", "greedy", "binary" };
+    using Mesher = void (*)(const ChunkSnapshot&, ChunkMeshData&);
+    constexpr std::array<Mesher, 3> meshers{ ChunkMesher::meshCulled, ChunkMesher::meshGreedy, ChunkMesher::meshBinary };
+
+    // Faces per second counts visible voxel faces, culled's quad count, so merging meshers are rated on the same work
+    std::cout << std::fixed << std::setprecision(1) << "Face instances, best of " << repeats << " batches\n";
+    for (int terrain{ 0 }; terrain < terrainCount; ++terrain)
+    {
+        World world{};
+        generate(world, static_cast<Terrain>(terrain));
+        const ChunkSnapshot snapshot{ world, ChunkCoord{ 0, 0, 0 } };
+
+        // The mesh is reused like a worker's, so the timings don't include growing its buffers
+        ChunkMeshData mesh{ .format = MeshConstants::faceInstances };
+        std::array<std::size_t, meshers.size()> quads{};
+        std::array<std::size_t, meshers.size()> vertices{};
+        std::array<double, meshers.size()> times{};
+        for (std::size_t i{ 0 }; i < meshers.size(); ++i)
+        {
+            times[i] = timeMesher(repeats, [&] {
+                meshers[i](snapshot, mesh);
+                return mesh.faceCount;
+            });
+            quads[i] = mesh.faceCount;
+            vertices[i] = mesh.getVertexCount();
+        }
+
+        // Greedy and binary merge the same faces, a different count means one of them is wrong
+        if (quads[1] != quads[2])
+        {
+            std::cout << names[terrain] << ": greedy and binary disagree on the quads\n";
+            return -1;
+        }
+
+        std::cout << names[terrain] << '\n';
+        for (std::size_t i{ 0 }; i < meshers.size(); ++i)
+        {
+            std::cout << "  " << std::left << std::setw(7) << mesherNames[i] << std::right << std::setw(9) << times[i] << " us  "
+                      << std::setw(6) << quads[i] << " quads  " << std::setw(7) << vertices[i] << " vertices  "
+                      << std::setw(7) << quads[0] / times[i] << " Mfaces/s\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Offline region compactor, rewrites every region file in a chunk directory to drop free sectors.
+// Run it only while the game isn't using the directory: RegionCompact <chunk directory>
+
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <system_error>
+
+#include "../Core/World/RegionFile.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: RegionCompact <chunk directory>\n";
+        return -1;
+    }
+
+    std::error_code error{};
+    std::filesystem::directory_iterator directory{ argv[1], error };
+    if (error)
+    {
+        std::cout << "Failed to open chunk directory: " << argv[1] << '\n';
+        return -1;
+    }
+
+    int failed{ 0 };
+    for (const auto& entry : directory)
+    {
+        const std::optional<ChunkCoord> region{ RegionFile::parseName(entry.path()) };
+        if (!region)
+            continue;
+
+        RegionFile file{ entry.path(), *region };
+        if (!file.isOpen())
+        {
+            ++failed;
+            continue;
+        }
+
+        const std::size_t sectorsBefore{ file.getSectorCount() };
+        const std::size_t freeBefore{ file.getFreeSectorCount() };
+        if (!file.compact())
+        {
+            ++failed;
+            continue;
+        }
+
+        std::cout << entry.path().filename().string() << ": " << sectorsBefore << " sectors (" << freeBefore << " free) -> "
+                  << file.getSectorCount() << " sectors (" << file.getFreeSectorCount() << " free)\n";
+    }
+
+    return failed == 0 ? 0 : -1;
+}